@@ -29,6 +29,7 @@ public class FGMovement : ModuleRules
             "InputCore",
 			"NetCore",
             "EnhancedInput",
+			"Projects",
 		});
 	}
 }
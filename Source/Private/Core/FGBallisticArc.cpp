@@ -0,0 +1,108 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGBallisticArc.h"
+#include "Core/FGMovementStats.h"
+#include "FGMovementCVars.h"
+#include "FGMovementTrace.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+
+namespace FG::Ballistic
+{
+	// Steps to skip casting after a cast that was blocked from the start.
+	constexpr int32 BlockedCastCooldown = 4;
+
+	// Slack for quantized sync state locations, which sit a fraction of a unit off the integrated path.
+	constexpr double LocationSlack = 0.1;
+}
+
+void FFGBallisticArc::Cast(FFGMoverCostStats& Stats, UPrimitiveComponent* UpdatedPrimitive, const FVector& Location, const FVector& Velocity,
+	float GravitySpeed, float DeltaTime, float FloorSweepDistance)
+{
+	FG_SCOPE_CYCLE(FFGBallisticArc::Cast);
+	FG::Trace::Count(FG::Trace::FrameCounters.Sweeps);
+	++Stats.TickSweeps;
+
+	const double Horizon = FG::CVars::BallisticHorizon;
+	const FVector End = FG::Kinematics::BallisticLocation(Location, Velocity, GravitySpeed, Horizon);
+
+	// Stepping velocity then location falls behind the exact parabola by g * dt * t / 2.
+	const double StepDrift = 0.5 * GravitySpeed * DeltaTime * Horizon;
+
+	Origin		= Location;
+	ClearEnd	= Location;
+	Margin		= FG::Kinematics::BallisticSagitta(GravitySpeed, Horizon) + StepDrift + FG::Ballistic::LocationSlack;
+	bValid		= true;
+
+	const float Inflation = static_cast<float>(Margin) + FloorSweepDistance;
+
+	// Static geometry only, movable primitives are swept step by step.
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FGBallisticArc), false, UpdatedPrimitive->GetOwner());
+	FCollisionResponseParams ResponseParams;
+	UpdatedPrimitive->InitSweepCollisionParams(QueryParams, ResponseParams);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	FHitResult Hit;
+	const bool bHit = UpdatedPrimitive->GetWorld()->SweepSingleByChannel(Hit, Location, End, UpdatedPrimitive->GetComponentQuat(),
+		UpdatedPrimitive->GetCollisionObjectType(), UpdatedPrimitive->GetCollisionShape(Inflation), QueryParams, ResponseParams);
+
+	// Anything within Margin of the chord up to the first hit is clear, floor distance included.
+	if(!bHit)
+	{
+		ClearEnd = End;
+	}
+	else if(!Hit.bStartPenetrating)
+	{
+		ClearEnd = Location + (End - Location) * Hit.Time;
+	}
+
+	if(ClearEnd == Origin)
+	{
+		CastCooldown = FG::Ballistic::BlockedCastCooldown;
+	}
+}
+
+bool FFGBallisticArc::SweepDynamic(FFGMoverCostStats& Stats, UPrimitiveComponent* UpdatedPrimitive, const FVector& StartLocation, const FVector& EndLocation,
+	float FloorSweepDistance)
+{
+	FG_SCOPE_CYCLE(FFGBallisticArc::SweepDynamic);
+	FG::Trace::Count(FG::Trace::FrameCounters.Sweeps);
+	++Stats.TickSweeps;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FGBallisticStep), false, UpdatedPrimitive->GetOwner());
+	FCollisionResponseParams ResponseParams;
+	UpdatedPrimitive->InitSweepCollisionParams(QueryParams, ResponseParams);
+	QueryParams.MobilityType = EQueryMobilityType::Dynamic;
+
+	return !UpdatedPrimitive->GetWorld()->SweepTestByChannel(StartLocation, EndLocation, UpdatedPrimitive->GetComponentQuat(),
+		UpdatedPrimitive->GetCollisionObjectType(), UpdatedPrimitive->GetCollisionShape(FloorSweepDistance), QueryParams, ResponseParams);
+}
+
+bool FFGBallisticArc::ShouldCast()
+{
+	if(CastCooldown > 0)
+	{
+		--CastCooldown;
+		return false;
+	}
+	return true;
+}
+
+bool FFGBallisticArc::CanAdvance(const FVector& StartLocation, const FVector& EndLocation) const
+{
+	if(!bValid || ClearEnd == Origin)
+	{
+		return false;
+	}
+
+	// The swept volume is convex, so a straight step with both ends inside it stays inside it.
+	return FMath::PointDistToSegment(StartLocation, Origin, ClearEnd) <= Margin
+		&& FMath::PointDistToSegment(EndLocation, Origin, ClearEnd) <= Margin;
+}
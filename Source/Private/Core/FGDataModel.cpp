@@ -8,13 +8,375 @@
 // SOFTWARE.
 
 #include "Core/FGDataModel.h"
+#include "Core/FGInputRecording.h"
+#include "Engine/NetSerialization.h"
+#include "HAL/IConsoleManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FGDataModel)
 
+namespace FG::Net
+{
+	// Directional move input is sent as hundredths, which keeps it exact with the 0.01 precision
+	// FCharacterDefaultInputs::SetMoveInput is happy to store.
+	constexpr double MoveInputScale = 100.0;
+
+	enum EInputButtons : uint8
+	{
+		Button_JumpJustPressed	= 1 << 0,
+		Button_Jump				= 1 << 1,
+		Button_Crouch			= 1 << 2,
+		Button_Sprint			= 1 << 3,
+		Button_NumBits			= 4,
+	};
+
+	enum EInputFields : uint8
+	{
+		Field_Buttons			= 1 << 0,
+		Field_MoveInput			= 1 << 1,
+		Field_Orientation		= 1 << 2,
+		Field_ControlRotation	= 1 << 3,
+		Field_NumBits			= 4,
+	};
+
+	static int32 LocationPrecision = 1;
+	static FAutoConsoleVariableRef CVarLocationPrecision(
+		TEXT("FG.Net.LocationPrecision"),
+		LocationPrecision,
+		TEXT("Precision FG sync state locations replicate with - 0 whole cm, 1 tenths, 2 hundredths. ")
+		TEXT("Every extra digit costs ~3 bits per axis, and so does every doubling of distance from the origin. Must match on server and clients."),
+		ECVF_ReadOnly
+	);
+
+	static bool bDeltaInputs = true;
+	static FAutoConsoleVariableRef CVarDeltaInputs(
+		TEXT("FG.Net.DeltaInputs"),
+		bDeltaInputs,
+		TEXT("Delta compress FG input cmds against the previous cmd of the same input RPC (0/1). Only affects the sender."),
+		ECVF_Default
+	);
+
+	/**
+	 * An input cmd in exactly the precision it goes over the wire.
+	 * Everything but the movement base and suggested mode, which are rare and always sent in full.
+	 */
+	struct FPackedInput
+	{
+		FVector	VelocityMoveInput	= FVector::ZeroVector;	// Only for EMoveInputType::Velocity.
+		int8	MoveInput[3]		= { 0, 0, 0 };			// Only for EMoveInputType::DirectionalIntent.
+		uint16	OrientationPitch	= 0;
+		uint16	OrientationYaw		= 0;
+		uint16	ControlPitch		= 0;
+		uint16	ControlYaw			= 0;
+		uint8	Buttons				= 0;
+		uint8	MoveInputType		= 0;
+		bool	bHasMoveInput		= false;
+		bool	bHasOrientation		= false;
+
+		bool MoveInputEquals(const FPackedInput& Other) const
+		{
+			return MoveInputType == Other.MoveInputType
+				&& bHasMoveInput == Other.bHasMoveInput
+				&& FMemory::Memcmp(MoveInput, Other.MoveInput, sizeof(MoveInput)) == 0
+				&& VelocityMoveInput == Other.VelocityMoveInput;
+		}
+
+		bool OrientationEquals(const FPackedInput& Other) const
+		{
+			return bHasOrientation == Other.bHasOrientation
+				&& OrientationPitch == Other.OrientationPitch
+				&& OrientationYaw == Other.OrientationYaw;
+		}
+
+		bool ControlRotationEquals(const FPackedInput& Other) const
+		{
+			return ControlPitch == Other.ControlPitch && ControlYaw == Other.ControlYaw;
+		}
+	};
+
+	/**
+	 * Last cmd serialized in the input batch open on this thread, see FScopedInputBatch. A batch is
+	 * written and read in the same order within one RPC, so the next cmd can refer to this one.
+	 */
+	struct FInputBaseline
+	{
+		FPackedInput	Input;
+		bool			bValid		= false;
+	};
+
+	static thread_local FInputBaseline BatchBaseline;
+	static thread_local bool bInInputBatch = false;
+
+	FScopedInputBatch::FScopedInputBatch()
+		: bWasInBatch(bInInputBatch)
+	{
+		bInInputBatch = true;
+		BatchBaseline.bValid = false;
+	}
+
+	FScopedInputBatch::~FScopedInputBatch()
+	{
+		// An enclosing batch can't trust the baseline any more, its next cmd goes in full.
+		bInInputBatch = bWasInBatch;
+		BatchBaseline.bValid = false;
+	}
+
+	FORCEINLINE int8 QuantizeMoveAxis(double Value)
+	{
+		return static_cast<int8>(FMath::Clamp(FMath::RoundToInt(Value * MoveInputScale), -127, 127));
+	}
+
+	FORCEINLINE double DequantizeMoveAxis(int8 Value)
+	{
+		return Value / MoveInputScale;
+	}
+
+	static FPackedInput Pack(const FFGMoverInputCmd& Cmd)
+	{
+		FPackedInput Packed;
+
+		Packed.Buttons |= Cmd.bIsJumpJustPressed	? Button_JumpJustPressed : 0;
+		Packed.Buttons |= Cmd.bIsJumpPressed		? Button_Jump : 0;
+		Packed.Buttons |= Cmd.bIsCrouchPressed		? Button_Crouch : 0;
+		Packed.Buttons |= Cmd.bIsSprintPressed		? Button_Sprint : 0;
+
+		const FVector& MoveInput = Cmd.GetMoveInput();
+		Packed.MoveInputType = static_cast<uint8>(Cmd.MoveInputType);
+
+		if(Cmd.MoveInputType == EMoveInputType::DirectionalIntent)
+		{
+			Packed.MoveInput[0] = QuantizeMoveAxis(MoveInput.X);
+			Packed.MoveInput[1] = QuantizeMoveAxis(MoveInput.Y);
+			Packed.MoveInput[2] = QuantizeMoveAxis(MoveInput.Z);
+			Packed.bHasMoveInput = Packed.MoveInput[0] != 0 || Packed.MoveInput[1] != 0 || Packed.MoveInput[2] != 0;
+		}
+		else
+		{
+			// Velocity input goes through SerializePackedVector<10, 16>, i.e. tenths.
+			Packed.VelocityMoveInput = FVector(
+				FMath::RoundToDouble(MoveInput.X * 10.0) / 10.0,
+				FMath::RoundToDouble(MoveInput.Y * 10.0) / 10.0,
+				FMath::RoundToDouble(MoveInput.Z * 10.0) / 10.0);
+			Packed.bHasMoveInput = !Packed.VelocityMoveInput.IsZero();
+		}
+
+		Packed.bHasOrientation = !Cmd.OrientationIntent.IsNearlyZero();
+		if(Packed.bHasOrientation)
+		{
+			const FRotator OrientationRot = Cmd.OrientationIntent.Rotation();
+			Packed.OrientationPitch = FRotator::CompressAxisToShort(OrientationRot.Pitch);
+			Packed.OrientationYaw = FRotator::CompressAxisToShort(OrientationRot.Yaw);
+		}
+
+		Packed.ControlPitch = FRotator::CompressAxisToShort(Cmd.ControlRotation.Pitch);
+		Packed.ControlYaw = FRotator::CompressAxisToShort(Cmd.ControlRotation.Yaw);
+
+		return Packed;
+	}
+
+	static void Unpack(const FPackedInput& Packed, FFGMoverInputCmd& Cmd)
+	{
+		Cmd.bIsJumpJustPressed	= (Packed.Buttons & Button_JumpJustPressed) != 0;
+		Cmd.bIsJumpPressed		= (Packed.Buttons & Button_Jump) != 0;
+		Cmd.bIsCrouchPressed	= (Packed.Buttons & Button_Crouch) != 0;
+		Cmd.bIsSprintPressed	= (Packed.Buttons & Button_Sprint) != 0;
+
+		const EMoveInputType InputType = static_cast<EMoveInputType>(Packed.MoveInputType);
+		FVector MoveInput = FVector::ZeroVector;
+
+		if(Packed.bHasMoveInput)
+		{
+			MoveInput = InputType == EMoveInputType::DirectionalIntent ?
+				FVector(DequantizeMoveAxis(Packed.MoveInput[0]), DequantizeMoveAxis(Packed.MoveInput[1]), DequantizeMoveAxis(Packed.MoveInput[2])) :
+				Packed.VelocityMoveInput;
+		}
+
+		Cmd.SetMoveInput(InputType, MoveInput);
+
+		Cmd.OrientationIntent = Packed.bHasOrientation ?
+			FRotator(FRotator::DecompressAxisFromShort(Packed.OrientationPitch), FRotator::DecompressAxisFromShort(Packed.OrientationYaw), 0.0).Vector() :
+			FVector::ZeroVector;
+
+		Cmd.ControlRotation = FRotator(FRotator::DecompressAxisFromShort(Packed.ControlPitch), FRotator::DecompressAxisFromShort(Packed.ControlYaw), 0.0);
+	}
+
+	static void SerializeButtons(FArchive& Ar, FPackedInput& Packed)
+	{
+		Ar.SerializeBits(&Packed.Buttons, Button_NumBits);
+	}
+
+	// Zero move input is by far the most common, so it only costs a bit.
+	static void SerializeMoveInput(FArchive& Ar, FPackedInput& Packed, bool& bOutSuccess)
+	{
+		Ar.SerializeBits(&Packed.MoveInputType, 2);
+		Ar.SerializeBits(&Packed.bHasMoveInput, 1);
+
+		const bool bDirectional = static_cast<EMoveInputType>(Packed.MoveInputType) == EMoveInputType::DirectionalIntent;
+
+		// Clear whatever isn't sent, so the reader's baseline matches the writer's exactly.
+		if(Ar.IsLoading())
+		{
+			if(!Packed.bHasMoveInput || !bDirectional)
+			{
+				FMemory::Memzero(Packed.MoveInput);
+			}
+			if(!Packed.bHasMoveInput || bDirectional)
+			{
+				Packed.VelocityMoveInput = FVector::ZeroVector;
+			}
+		}
+
+		if(!Packed.bHasMoveInput)
+		{
+			return;
+		}
+
+		if(bDirectional)
+		{
+			Ar << Packed.MoveInput[0];
+			Ar << Packed.MoveInput[1];
+			Ar << Packed.MoveInput[2];
+		}
+		else
+		{
+			bOutSuccess &= SerializePackedVector<10, 16>(Packed.VelocityMoveInput, Ar);
+		}
+	}
+
+	// Pitch and yaw only - FG pawns are always upright.
+	static void SerializeOrientation(FArchive& Ar, FPackedInput& Packed)
+	{
+		Ar.SerializeBits(&Packed.bHasOrientation, 1);
+
+		if(Packed.bHasOrientation)
+		{
+			Ar << Packed.OrientationPitch;
+			Ar << Packed.OrientationYaw;
+		}
+		else if(Ar.IsLoading())
+		{
+			Packed.OrientationPitch = 0;
+			Packed.OrientationYaw = 0;
+		}
+	}
+
+	// Looking around rarely moves more than a degree or two per frame, send a small delta when we can.
+	static void SerializeAxisDelta(FArchive& Ar, uint16& Value, uint16 BaselineValue)
+	{
+		int16 Delta = static_cast<int16>(Value - BaselineValue);
+		bool bSmallDelta = Delta >= MIN_int8 && Delta <= MAX_int8;
+		Ar.SerializeBits(&bSmallDelta, 1);
+
+		if(bSmallDelta)
+		{
+			int8 SmallDelta = static_cast<int8>(Delta);
+			Ar << SmallDelta;
+			Value = static_cast<uint16>(BaselineValue + SmallDelta);
+		}
+		else
+		{
+			Ar << Value;
+		}
+	}
+
+	FORCEINLINE EVectorQuantization GetLocationQuantization()
+	{
+		switch(LocationPrecision)
+		{
+		case 0:		return EVectorQuantization::RoundWholeNumber;
+		case 2:		return EVectorQuantization::RoundTwoDecimals;
+		default:	return EVectorQuantization::RoundOneDecimal;
+		}
+	}
+
+	FORCEINLINE double GetLocationScale()
+	{
+		switch(GetLocationQuantization())
+		{
+		case EVectorQuantization::RoundWholeNumber:	return 1.0;
+		case EVectorQuantization::RoundTwoDecimals:	return 100.0;
+		default:									return 10.0;
+		}
+	}
+
+	FORCEINLINE FVector QuantizeVector(const FVector& Value, double Scale)
+	{
+		return FVector(
+			FMath::RoundToDouble(Value.X * Scale) / Scale,
+			FMath::RoundToDouble(Value.Y * Scale) / Scale,
+			FMath::RoundToDouble(Value.Z * Scale) / Scale);
+	}
+
+	FORCEINLINE double QuantizeAxis(double Angle)
+	{
+		return FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Angle));
+	}
+
+	// Move intent is a direction (or nothing), so pitch and yaw are enough.
+	FORCEINLINE FVector QuantizeDirection(const FVector& Direction)
+	{
+		if(Direction.IsNearlyZero())
+		{
+			return FVector::ZeroVector;
+		}
+
+		const FRotator DirectionRot = Direction.Rotation();
+		return FRotator(QuantizeAxis(DirectionRot.Pitch), QuantizeAxis(DirectionRot.Yaw), 0.0).Vector();
+	}
+
+}
+
+FG_IMPLEMENT_POOLED_ALLOCATOR(FFGMoverInputCmd)
+FG_IMPLEMENT_POOLED_ALLOCATOR(FFGMoverSyncState)
+
 FFGMoverInputCmd::FFGMoverInputCmd()
 	: bIsCrouchPressed(false)
+	, bIsSprintPressed(false)
 {}
 
+void FFGMoverInputCmd::Quantize()
+{
+	FG::Net::Unpack(FG::Net::Pack(*this), *this);
+
+	if(!bUsingMovementBase)
+	{
+		MovementBase = nullptr;
+		MovementBaseBoneName = NAME_None;
+	}
+}
+
+void FFGInputSample::Pack(const FFGMoverInputCmd& Cmd)
+{
+	const FG::Net::FPackedInput Packed = FG::Net::Pack(Cmd);
+
+	FMemory::Memcpy(MoveInput, Packed.MoveInput, sizeof(MoveInput));
+	Buttons				= Packed.Buttons;
+	OrientationPitch	= Packed.OrientationPitch;
+	OrientationYaw		= Packed.OrientationYaw;
+	ControlPitch		= Packed.ControlPitch;
+	ControlYaw			= Packed.ControlYaw;
+	Flags				= Packed.bHasOrientation ? Flag_HasOrientation : 0;
+}
+
+void FFGInputSample::Unpack(FFGMoverInputCmd& Cmd) const
+{
+	FG::Net::FPackedInput Packed;
+
+	FMemory::Memcpy(Packed.MoveInput, MoveInput, sizeof(MoveInput));
+	Packed.MoveInputType	= static_cast<uint8>(EMoveInputType::DirectionalIntent);
+	Packed.bHasMoveInput	= MoveInput[0] != 0 || MoveInput[1] != 0 || MoveInput[2] != 0;
+	Packed.Buttons			= Buttons;
+	Packed.OrientationPitch	= OrientationPitch;
+	Packed.OrientationYaw	= OrientationYaw;
+	Packed.ControlPitch		= ControlPitch;
+	Packed.ControlYaw		= ControlYaw;
+	Packed.bHasOrientation	= (Flags & Flag_HasOrientation) != 0;
+
+	FG::Net::Unpack(Packed, Cmd);
+	Cmd.bUsingMovementBase = false;
+	Cmd.MovementBase = nullptr;
+	Cmd.MovementBaseBoneName = NAME_None;
+}
+
 FMoverDataStructBase* FFGMoverInputCmd::Clone() const
 {
 	FFGMoverInputCmd* CopyPtr = new FFGMoverInputCmd(*this);
@@ -23,12 +385,285 @@ FMoverDataStructBase* FFGMoverInputCmd::Clone() const
 
 bool FFGMoverInputCmd::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
 {
-	Ar.SerializeBits(&bIsCrouchPressed, 1);
-	return FCharacterDefaultInputs::NetSerialize(Ar, Map, bOutSuccess);
+	using namespace FG::Net;
+
+	bOutSuccess = true;
+
+	FPackedInput Packed;
+	if(Ar.IsSaving())
+	{
+		Packed = Pack(*this);
+	}
+
+	// Only cmds inside an input batch have a baseline both ends agree on, anything else goes in full.
+	FInputBaseline& Baseline = BatchBaseline;
+	const bool bHasBaseline = bInInputBatch && Baseline.bValid;
+
+	bool bDelta = false;
+	if(Ar.IsSaving())
+	{
+		bDelta = bDeltaInputs && bHasBaseline;
+	}
+
+	Ar.SerializeBits(&bDelta, 1);
+
+	if(bDelta)
+	{
+		if(Ar.IsLoading() && !bHasBaseline)
+		{
+			// Sender thinks we have a baseline we don't, nothing sensible to read from here.
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+
+		const FPackedInput& Base = Baseline.Input;
+
+		uint8 ChangedFields = 0;
+		if(Ar.IsSaving())
+		{
+			ChangedFields |= Packed.Buttons != Base.Buttons ? Field_Buttons : 0;
+			ChangedFields |= !Packed.MoveInputEquals(Base) ? Field_MoveInput : 0;
+			ChangedFields |= !Packed.OrientationEquals(Base) ? Field_Orientation : 0;
+			ChangedFields |= !Packed.ControlRotationEquals(Base) ? Field_ControlRotation : 0;
+		}
+
+		// A repeated cmd costs two bits, a held key while looking around a handful of bytes.
+		bool bRepeat = ChangedFields == 0;
+		Ar.SerializeBits(&bRepeat, 1);
+
+		if(bRepeat)
+		{
+			Packed = Base;
+		}
+		else
+		{
+			Ar.SerializeBits(&ChangedFields, Field_NumBits);
+
+			if(Ar.IsLoading())
+			{
+				Packed = Base;
+			}
+
+			if(ChangedFields & Field_Buttons)
+			{
+				SerializeButtons(Ar, Packed);
+			}
+			if(ChangedFields & Field_MoveInput)
+			{
+				SerializeMoveInput(Ar, Packed, bOutSuccess);
+			}
+			if(ChangedFields & Field_Orientation)
+			{
+				Ar.SerializeBits(&Packed.bHasOrientation, 1);
+				if(Packed.bHasOrientation)
+				{
+					SerializeAxisDelta(Ar, Packed.OrientationPitch, Base.OrientationPitch);
+					SerializeAxisDelta(Ar, Packed.OrientationYaw, Base.OrientationYaw);
+				}
+				else if(Ar.IsLoading())
+				{
+					Packed.OrientationPitch = 0;
+					Packed.OrientationYaw = 0;
+				}
+			}
+			if(ChangedFields & Field_ControlRotation)
+			{
+				SerializeAxisDelta(Ar, Packed.ControlPitch, Base.ControlPitch);
+				SerializeAxisDelta(Ar, Packed.ControlYaw, Base.ControlYaw);
+			}
+		}
+	}
+	else
+	{
+		SerializeButtons(Ar, Packed);
+		SerializeMoveInput(Ar, Packed, bOutSuccess);
+		SerializeOrientation(Ar, Packed);
+		Ar << Packed.ControlPitch;
+		Ar << Packed.ControlYaw;
+	}
+
+	if(bInInputBatch)
+	{
+		Baseline.Input = Packed;
+		Baseline.bValid = true;
+	}
+
+	if(Ar.IsLoading())
+	{
+		Unpack(Packed, *this);
+	}
+
+	// Rarely used fields, a bit each unless they're set.
+	bool bHasSuggestedMode = !SuggestedMovementMode.IsNone();
+	Ar.SerializeBits(&bHasSuggestedMode, 1);
+
+	if(bHasSuggestedMode)
+	{
+		Ar << SuggestedMovementMode;
+	}
+	else if(Ar.IsLoading())
+	{
+		SuggestedMovementMode = NAME_None;
+	}
+
+	Ar.SerializeBits(&bUsingMovementBase, 1);
+
+	if(bUsingMovementBase)
+	{
+		Ar << MovementBase;
+		Ar << MovementBaseBoneName;
+	}
+	else if(Ar.IsLoading())
+	{
+		MovementBase = nullptr;
+		MovementBaseBoneName = NAME_None;
+	}
+
+	bOutSuccess &= !Ar.IsError();
+	return true;
 }
 
 void FFGMoverInputCmd::ToString(FAnsiStringBuilderBase& Out) const
 {
 	FCharacterDefaultInputs::ToString(Out);
 	Out.Appendf("bIsCrouchPressed: %i\n", bIsCrouchPressed);
+	Out.Appendf("bIsSprintPressed: %i\n", bIsSprintPressed);
+}
+
+void FFGMoverSyncState::Quantize()
+{
+	// Based movers replicate in full precision.
+	if(MovementBase.IsValid())
+	{
+		return;
+	}
+
+	Location = FG::Net::QuantizeVector(Location, FG::Net::GetLocationScale());
+	Velocity = FG::Net::QuantizeVector(Velocity, 10.0);
+	Orientation = FRotator(0.0, FG::Net::QuantizeAxis(Orientation.Yaw), 0.0);
+	MoveDirectionIntent = FG::Net::QuantizeDirection(MoveDirectionIntent);
+}
+
+FMoverDataStructBase* FFGMoverSyncState::Clone() const
+{
+	FFGMoverSyncState* CopyPtr = new FFGMoverSyncState(*this);
+	return CopyPtr;
+}
+
+bool FFGMoverSyncState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	using namespace FG::Net;
+
+	bOutSuccess = true;
+
+	bool bHasBase = MovementBase.IsValid();
+	Ar.SerializeBits(&bHasBase, 1);
+
+	if(bHasBase)
+	{
+		FMoverDefaultSyncState::NetSerialize(Ar, Map, bOutSuccess);
+	}
+	else
+	{
+		if(Ar.IsLoading())
+		{
+			MovementBase = nullptr;
+			MovementBaseBoneName = NAME_None;
+			MovementBasePos = FVector::ZeroVector;
+			MovementBaseQuat = FQuat::Identity;
+		}
+
+		bOutSuccess &= SerializeQuantizedVector(Ar, Location, GetLocationQuantization());
+
+		// Standing still is common enough to be worth a bit.
+		bool bHasVelocity = !Velocity.IsZero();
+		Ar.SerializeBits(&bHasVelocity, 1);
+
+		if(bHasVelocity)
+		{
+			bOutSuccess &= SerializeQuantizedVector(Ar, Velocity, EVectorQuantization::RoundOneDecimal);
+		}
+		else if(Ar.IsLoading())
+		{
+			Velocity = FVector::ZeroVector;
+		}
+
+		// Yaw only - FG pawns are always upright.
+		uint16 Yaw = FRotator::CompressAxisToShort(Orientation.Yaw);
+		Ar << Yaw;
+
+		if(Ar.IsLoading())
+		{
+			Orientation = FRotator(0.0, FRotator::DecompressAxisFromShort(Yaw), 0.0);
+		}
+
+		bool bHasMoveIntent = !MoveDirectionIntent.IsNearlyZero();
+		Ar.SerializeBits(&bHasMoveIntent, 1);
+
+		if(bHasMoveIntent)
+		{
+			const FRotator IntentRot = MoveDirectionIntent.Rotation();
+			uint16 IntentPitch = FRotator::CompressAxisToShort(IntentRot.Pitch);
+			uint16 IntentYaw = FRotator::CompressAxisToShort(IntentRot.Yaw);
+			Ar << IntentPitch;
+			Ar << IntentYaw;
+
+			if(Ar.IsLoading())
+			{
+				MoveDirectionIntent = FRotator(FRotator::DecompressAxisFromShort(IntentPitch), FRotator::DecompressAxisFromShort(IntentYaw), 0.0).Vector();
+			}
+		}
+		else if(Ar.IsLoading())
+		{
+			MoveDirectionIntent = FVector::ZeroVector;
+		}
+	}
+
+	uint8 NumFloorless = FMath::Min<uint8>(FloorlessTicks, 3);
+	Ar.SerializeBits(&NumFloorless, 2);
+	FloorlessTicks = NumFloorless;
+
+	// Resting movers don't count idle ticks any more, and moving ones don't have any.
+	Ar.SerializeBits(&bResting, 1);
+
+	bool bHasIdleTicks = !bResting && IdleTicks > 0;
+	Ar.SerializeBits(&bHasIdleTicks, 1);
+
+	if(bHasIdleTicks)
+	{
+		Ar << IdleTicks;
+	}
+	else if(Ar.IsLoading())
+	{
+		IdleTicks = 0;
+	}
+
+	bOutSuccess &= !Ar.IsError();
+	return true;
+}
+
+void FFGMoverSyncState::ToString(FAnsiStringBuilderBase& Out) const
+{
+	FMoverDefaultSyncState::ToString(Out);
+	Out.Appendf("FloorlessTicks: %i\n", static_cast<int32>(FloorlessTicks));
+	Out.Appendf("IdleTicks: %i Resting: %i\n", static_cast<int32>(IdleTicks), bResting ? 1 : 0);
+}
+
+bool FFGMoverSyncState::ShouldReconcile(const FMoverDataStructBase& AuthorityState) const
+{
+	// Rest is woken by things only one side may see (overlaps, gameplay calling WakeFromRest), so a
+	// client still resting where the server woke up has to be corrected even if it hasn't moved yet.
+	return FMoverDefaultSyncState::ShouldReconcile(AuthorityState)
+		|| bResting != static_cast<const FFGMoverSyncState&>(AuthorityState).bResting;
+}
+
+void FFGMoverSyncState::Interpolate(const FMoverDataStructBase& From, const FMoverDataStructBase& To, float Pct)
+{
+	FMoverDefaultSyncState::Interpolate(From, To, Pct);
+
+	// Counters don't blend, take the ones we're heading to.
+	FloorlessTicks = static_cast<const FFGMoverSyncState&>(To).FloorlessTicks;
+	IdleTicks = static_cast<const FFGMoverSyncState&>(To).IdleTicks;
+	bResting = static_cast<const FFGMoverSyncState&>(To).bResting;
 }
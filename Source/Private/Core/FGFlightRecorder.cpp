@@ -0,0 +1,141 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGFlightRecorder.h"
+#include "Core/FGDataModel.h"
+#include "Core/FGMoverComponent.h"
+#include "FGMovementDefines.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "MoveLibrary/FloorQueryUtils.h"
+#include "MoverSimulationTypes.h"
+#include "UObject/UObjectIterator.h"
+
+FArchive& operator<<(FArchive& Ar, FFGFlightSample& Sample)
+{
+	Ar << Sample.SimFrame;
+	Ar << Sample.SimTimeMs;
+	Ar << Sample.Location;
+	Ar << Sample.Velocity;
+	Ar << Sample.MoveInput;
+	Ar << Sample.FloorNormal;
+	Ar << Sample.FloorDistance;
+	Ar << Sample.Mode;
+	Ar << Sample.Flags;
+	Ar << Sample.TransitionReason;
+	return Ar;
+}
+
+void FFGFlightRecorder::RecordSample(const FMoverTimeStep& TimeStep, EFGModeId ModeId, const FMoverDefaultSyncState& SyncState,
+	const FFGMoverInputCmd* InputCmd, const FFloorCheckResult* Floor, EFGTransitionReason Reason)
+{
+	if(Samples.IsEmpty())
+	{
+		Samples.SetNum(Capacity);
+	}
+
+	FFGFlightSample& Sample = Samples[Head];
+
+	Sample.SimFrame			= TimeStep.ServerFrame;
+	Sample.SimTimeMs		= static_cast<float>(TimeStep.BaseSimTimeMs);
+	Sample.Location			= FVector3f(SyncState.GetLocation_WorldSpace());
+	Sample.Velocity			= FVector3f(SyncState.GetVelocity_WorldSpace());
+	Sample.Mode				= static_cast<uint8>(ModeId);
+	Sample.Flags			= 0;
+	Sample.TransitionReason	= Reason;
+
+	if(InputCmd)
+	{
+		Sample.MoveInput = FVector3f(InputCmd->GetMoveInput());
+		Sample.Flags |= InputCmd->bIsJumpPressed ? FFGFlightSample::Flag_JumpPressed : 0;
+		Sample.Flags |= InputCmd->bIsCrouchPressed ? FFGFlightSample::Flag_CrouchPressed : 0;
+	}
+	else
+	{
+		Sample.MoveInput = FVector3f::ZeroVector;
+	}
+
+	if(Floor)
+	{
+		Sample.FloorNormal = FVector3f(Floor->HitResult.ImpactNormal);
+		Sample.FloorDistance = Floor->FloorDist;
+		Sample.Flags |= Floor->bBlockingHit ? FFGFlightSample::Flag_BlockingFloor : 0;
+		Sample.Flags |= Floor->bWalkableFloor ? FFGFlightSample::Flag_WalkableFloor : 0;
+	}
+	else
+	{
+		Sample.FloorNormal = FVector3f::ZeroVector;
+		Sample.FloorDistance = 0.0f;
+	}
+
+	Head = (Head + 1) % Capacity;
+	Num = FMath::Min(Num + 1, Capacity);
+}
+
+void FFGFlightRecorder::Serialize(FArchive& Ar)
+{
+	uint32 FileMagic = Magic;
+	uint32 FileVersion = Version;
+	uint32 NumSamples = Num;
+
+	Ar << FileMagic;
+	Ar << FileVersion;
+	Ar << NumSamples;
+
+	const int32 Oldest = (Head - Num + Capacity) % Capacity;
+	for(int32 Idx = 0; Idx < Num; ++Idx)
+	{
+		Ar << Samples[(Oldest + Idx) % Capacity];
+	}
+}
+
+namespace FG::FlightRecorder
+{
+	static FAutoConsoleCommand CmdDump(
+		TEXT("FG.Recorder.Dump"),
+		TEXT("Writes the FG flight recorder buffer of one pawn (by name) or all pawns to Saved/FGMovement. Usage: FG.Recorder.Dump [PawnName]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Filter = Args.Num() > 0 ? Args[0] : FString();
+			const FString Timestamp = FDateTime::Now().ToString();
+			int32 NumDumped = 0;
+
+			for(TObjectIterator<UFGMoverComponent> It; It; ++It)
+			{
+				UFGMoverComponent* Mover = *It;
+				if(Mover->IsTemplate() || !Mover->GetOwner() || !Mover->GetWorld() || !Mover->GetWorld()->IsGameWorld())
+				{
+					continue;
+				}
+
+				const FString OwnerName = Mover->GetOwner()->GetName();
+				if(!Filter.IsEmpty() && Filter != TEXT("all") && OwnerName != Filter)
+				{
+					continue;
+				}
+
+				const FString Path = FPaths::ProjectSavedDir() / TEXT("FGMovement") / FString::Printf(TEXT("FlightRecorder_%s_%s.bin"), *OwnerName, *Timestamp);
+				if(TUniquePtr<FArchive> Writer = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*Path)))
+				{
+					Mover->GetFlightRecorder().Serialize(*Writer);
+					++NumDumped;
+				}
+				else
+				{
+					UE_LOGFMT(LogMover, Error, "FG.Recorder.Dump - Couldn't open {Path}", Path);
+				}
+			}
+
+			UE_LOGFMT(LogMover, Log, "FG.Recorder.Dump - Dumped {Num} flight recorders", NumDumped);
+		}));
+}
@@ -0,0 +1,256 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGFloorCache.h"
+#include "Core/FGMovementStats.h"
+#include "Core/FGMovementUtils.h"
+#include "FGMovementCVars.h"
+#include "FGMovementTrace.h"
+#include "Components/PrimitiveComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+
+namespace FG::FloorCache
+{
+	// How far the impact point may be off the box face it's supposed to be on (cm).
+	static constexpr double FacePlaneTolerance = 0.1;
+
+	// How closely the impact normal must match the box face normal, anything less is an edge or corner hit.
+	static constexpr double FaceNormalTolerance = 1.0e-3;
+}
+
+bool FFGFloorCache::FindFloorFace(const UPrimitiveComponent& FloorPrimitive, const FHitResult& Hit, FFloorFace& OutFace)
+{
+	// Only a single simple box: anything else (meshes, convex hulls, several elements) can change
+	// under the mover without the component moving.
+	const UBodySetup* BodySetup = const_cast<UPrimitiveComponent&>(FloorPrimitive).GetBodySetup();
+	if(!BodySetup || BodySetup->GetCollisionTraceFlag() == CTF_UseComplexAsSimple
+		|| BodySetup->AggGeom.GetElementCount() != 1 || BodySetup->AggGeom.BoxElems.Num() != 1)
+	{
+		return false;
+	}
+
+	const FKBoxElem& Box = BodySetup->AggGeom.BoxElems[0];
+	const FTransform& ComponentTransform = FloorPrimitive.GetComponentTransform();
+	const FVector Scale = ComponentTransform.GetScale3D();
+
+	// A rotated element under non uniform scale is sheared, not a box any more.
+	if(!Box.Rotation.IsNearlyZero() && !Scale.AllComponentsEqual())
+	{
+		return false;
+	}
+
+	const FQuat BoxRotation = ComponentTransform.GetRotation() * Box.Rotation.Quaternion();
+	const FVector BoxCenter = ComponentTransform.TransformPosition(Box.Center);
+	const FVector Axes[3] = { BoxRotation.GetAxisX(), BoxRotation.GetAxisY(), BoxRotation.GetAxisZ() };
+	const double HalfExtents[3] = { 0.5 * Box.X * FMath::Abs(Scale.X), 0.5 * Box.Y * FMath::Abs(Scale.Y), 0.5 * Box.Z * FMath::Abs(Scale.Z) };
+
+	for(int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const double Dot = Hit.ImpactNormal | Axes[Axis];
+		if(FMath::Abs(Dot) < 1.0 - FG::FloorCache::FaceNormalTolerance)
+		{
+			continue;
+		}
+
+		const double Sign = Dot > 0.0 ? 1.0 : -1.0;
+		OutFace.Normal	= Axes[Axis] * Sign;
+		OutFace.Origin	= BoxCenter + OutFace.Normal * HalfExtents[Axis];
+		OutFace.AxisU	= Axes[(Axis + 1) % 3];
+		OutFace.AxisV	= Axes[(Axis + 2) % 3];
+		OutFace.HalfU	= HalfExtents[(Axis + 1) % 3];
+		OutFace.HalfV	= HalfExtents[(Axis + 2) % 3];
+
+		return FMath::Abs((Hit.ImpactPoint - OutFace.Origin) | OutFace.Normal) <= FG::FloorCache::FacePlaneTolerance;
+	}
+
+	return false;
+}
+
+const FFloorCheckResult& FFGFloorCache::FindFloor(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+	float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, int32 ServerFrame, double SimTimeMs, bool bCanRollBack, uint64 Frame)
+{
+	bHasLastFloor = true;
+
+	// Nothing replays on the authority, the history would only ever be written.
+	if(!FG::CVars::FloorHistoryEnabled || !bCanRollBack)
+	{
+		QueryFloor(Stats, UpdatedComponent, UpdatedPrimitive, FloorSweepDistance, MaxWalkSlopeCosine, Location, Frame);
+		return LastFloor;
+	}
+
+	// A frame we simulated before, i.e. a replay after a correction.
+	if(History.Find(ServerFrame, SimTimeMs, Location, LastFloor))
+	{
+		++Stats.NumFloorHistoryHits;
+		FG::Trace::Count(FG::Trace::FrameCounters.FloorHistoryHits);
+		return LastFloor;
+	}
+
+	QueryFloor(Stats, UpdatedComponent, UpdatedPrimitive, FloorSweepDistance, MaxWalkSlopeCosine, Location, Frame);
+	History.Record(ServerFrame, SimTimeMs, Location, LastFloor);
+	return LastFloor;
+}
+
+void FFGFloorCache::QueryFloor(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+	float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, uint64 Frame)
+{
+	FFloorCheckResult& OutFloorResult = LastFloor;
+
+	if(FG::CVars::FloorCacheEnabled && CanReuse(UpdatedPrimitive, FloorSweepDistance, MaxWalkSlopeCosine, Location))
+	{
+		// Reproject the cached hit along the floor plane by however far we moved.
+		const FVector Delta = Location - CachedLocation;
+
+		OutFloorResult = CachedFloor;
+		OutFloorResult.HitResult.Location += Delta;
+		OutFloorResult.HitResult.ImpactPoint += Delta;
+		OutFloorResult.HitResult.TraceStart += Delta;
+		OutFloorResult.HitResult.TraceEnd += Delta;
+
+		++NumReuses;
+		++Stats.NumFloorCacheHits;
+		return;
+	}
+
+	if(ConsumePrefetch(UpdatedPrimitive, FloorSweepDistance, MaxWalkSlopeCosine, Location, Frame, OutFloorResult))
+	{
+		++Stats.NumFloorPrefetchHits;
+	}
+	else
+	{
+		FG::FindFloor(Stats, UpdatedComponent, UpdatedPrimitive, FloorSweepDistance, MaxWalkSlopeCosine, Location, OutFloorResult);
+	}
+
+	// Any floor is worth remembering, walkable or a ramp we're surfing along. Only on a box face
+	// can we tell from here what's further along, see CanReuse.
+	const UPrimitiveComponent* FloorPrimitive = OutFloorResult.HitResult.GetComponent();
+	bValid = OutFloorResult.bBlockingHit && FloorPrimitive != nullptr;
+	bOnFace = bValid && FindFloorFace(*FloorPrimitive, OutFloorResult.HitResult, CachedFace);
+	bValid &= bOnFace || FG::CVars::FloorCacheReuseDistance > 0.0f;
+
+	if(bValid)
+	{
+		CachedFloor				= OutFloorResult;
+		CachedFloorTransform	= FloorPrimitive->GetComponentTransform();
+		CachedLocation			= Location;
+		CachedShapeExtent		= UpdatedPrimitive->GetCollisionShape().GetExtent();
+		CachedFloorPrimitive	= FloorPrimitive;
+		CachedUpdatedPrimitive	= UpdatedPrimitive;
+		CachedSweepDistance		= FloorSweepDistance;
+		CachedSlopeCosine		= MaxWalkSlopeCosine;
+		NumReuses				= 0;
+	}
+}
+
+void FFGFloorCache::Prefetch(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+	float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, uint64 Frame)
+{
+	bPrefetched = false;
+
+	if(FG::CVars::FloorCacheEnabled && CanReuse(UpdatedPrimitive, FloorSweepDistance, MaxWalkSlopeCosine, Location))
+	{
+		return;
+	}
+
+	FG::FindFloor(Stats, UpdatedComponent, UpdatedPrimitive, FloorSweepDistance, MaxWalkSlopeCosine, Location, PrefetchedFloor);
+
+	// A miss can't be checked for staleness - anything could move into the sweep by the next
+	// frame, and there's no floor to see it moved. Only hits are kept.
+	const UPrimitiveComponent* FloorPrimitive = PrefetchedFloor.HitResult.GetComponent();
+	if(!PrefetchedFloor.bBlockingHit || !FloorPrimitive)
+	{
+		return;
+	}
+
+	PrefetchedFloorTransform	= FloorPrimitive->GetComponentTransform();
+	PrefetchedLocation			= Location;
+	PrefetchedFloorPrimitive	= FloorPrimitive;
+	PrefetchedUpdatedPrimitive	= UpdatedPrimitive;
+	PrefetchedSweepDistance		= FloorSweepDistance;
+	PrefetchedSlopeCosine		= MaxWalkSlopeCosine;
+	PrefetchedFrame				= Frame;
+	bPrefetched					= true;
+}
+
+bool FFGFloorCache::ConsumePrefetch(const UPrimitiveComponent* UpdatedPrimitive, float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location,
+	uint64 Frame, FFloorCheckResult& OutFloorResult)
+{
+	if(!bPrefetched)
+	{
+		return false;
+	}
+
+	bPrefetched = false;
+
+	// Only good for the frame after it was made, from the same spot, for the same query.
+	bool bUsable = Frame - PrefetchedFrame <= 1
+		&& PrefetchedUpdatedPrimitive.Get() == UpdatedPrimitive
+		&& PrefetchedSweepDistance == FloorSweepDistance
+		&& PrefetchedSlopeCosine == MaxWalkSlopeCosine
+		&& PrefetchedLocation.Equals(Location, UE_KINDA_SMALL_NUMBER);
+
+	// And whatever we hit must still be where it was.
+	if(bUsable)
+	{
+		const UPrimitiveComponent* FloorPrimitive = PrefetchedFloorPrimitive.Get();
+		bUsable = FloorPrimitive && FloorPrimitive->GetComponentTransform().Equals(PrefetchedFloorTransform);
+	}
+
+	FG::Trace::Count(bUsable ? FG::Trace::FrameCounters.FloorPrefetchHits : FG::Trace::FrameCounters.FloorPrefetchMisses);
+
+	if(bUsable)
+	{
+		OutFloorResult = PrefetchedFloor;
+	}
+	return bUsable;
+}
+
+bool FFGFloorCache::CanReuse(const UPrimitiveComponent* UpdatedPrimitive, float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location) const
+{
+	if(!bValid || NumReuses >= FG::CVars::FloorCacheMaxReuse)
+	{
+		return false;
+	}
+
+	// Same query against the same mover shape.
+	if(CachedUpdatedPrimitive.Get() != UpdatedPrimitive
+		|| CachedSweepDistance != FloorSweepDistance
+		|| CachedSlopeCosine != MaxWalkSlopeCosine
+		|| !CachedShapeExtent.Equals(UpdatedPrimitive->GetCollisionShape().GetExtent()))
+	{
+		return false;
+	}
+
+	// Floor must still be there, and not have moved under us.
+	const UPrimitiveComponent* FloorPrimitive = CachedFloorPrimitive.Get();
+	if(!FloorPrimitive || !FloorPrimitive->GetComponentTransform().Equals(CachedFloorTransform))
+	{
+		return false;
+	}
+
+	// We may only have slid along the floor plane, any movement off it needs a real sweep.
+	const FVector Delta = Location - CachedLocation;
+	if(FMath::Abs(Delta | CachedFloor.HitResult.ImpactNormal) > FG::CVars::FloorCacheTolerance)
+	{
+		return false;
+	}
+
+	// Off a box face we can't see edges or bumps coming, so stay close to where we last swept.
+	if(!bOnFace)
+	{
+		return Delta.SizeSquared() <= FMath::Square(FG::CVars::FloorCacheReuseDistance);
+	}
+
+	// And the whole footprint must still be on the face we hit, otherwise we could be walking off an edge.
+	const FVector FromFace = Location - CachedFace.Origin;
+	const double Radius = CachedShapeExtent.X;
+
+	return FMath::Abs(FromFace | CachedFace.AxisU) + Radius <= CachedFace.HalfU
+		&& FMath::Abs(FromFace | CachedFace.AxisV) + Radius <= CachedFace.HalfV;
+}
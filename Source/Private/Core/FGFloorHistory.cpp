@@ -0,0 +1,79 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGFloorHistory.h"
+#include "FGMovementCVars.h"
+#include "Components/PrimitiveComponent.h"
+
+bool FFGFloorHistory::Find(int32 ServerFrame, double SimTimeMs, const FVector& Location, FFloorCheckResult& OutFloor) const
+{
+	if(ServerFrame < 0)
+	{
+		return false;
+	}
+
+	const FEntry& Entry = Entries[ServerFrame % Capacity];
+	if(Entry.ServerFrame != ServerFrame || Entry.SimTimeMs != SimTimeMs || !Entry.Location.Equals(Location, FG::CVars::FloorHistoryTolerance))
+	{
+		return false;
+	}
+
+	// Anything we stood on must still be where it was the first time around.
+	if(Entry.Floor.bBlockingHit)
+	{
+		const UPrimitiveComponent* FloorPrimitive = Entry.FloorPrimitive.Get();
+		if(!FloorPrimitive || !FloorPrimitive->GetComponentTransform().Equals(Entry.FloorTransform))
+		{
+			return false;
+		}
+	}
+
+	const FVector Delta = Location - Entry.Location;
+
+	OutFloor = Entry.Floor;
+	OutFloor.HitResult.Location += Delta;
+	OutFloor.HitResult.ImpactPoint += Delta;
+	OutFloor.HitResult.TraceStart += Delta;
+	OutFloor.HitResult.TraceEnd += Delta;
+	return true;
+}
+
+void FFGFloorHistory::Record(int32 ServerFrame, double SimTimeMs, const FVector& Location, const FFloorCheckResult& Floor)
+{
+	if(ServerFrame < 0)
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries[ServerFrame % Capacity];
+
+	// A later substep of a frame we already have, i.e. the mode changed mid frame. Replays start
+	// the frame over at its first substep's time, so that's the one worth keeping.
+	if(Entry.ServerFrame == ServerFrame && SimTimeMs > Entry.SimTimeMs)
+	{
+		return;
+	}
+
+	const UPrimitiveComponent* FloorPrimitive = Floor.HitResult.GetComponent();
+
+	Entry.Floor				= Floor;
+	Entry.FloorTransform	= FloorPrimitive ? FloorPrimitive->GetComponentTransform() : FTransform::Identity;
+	Entry.Location			= Location;
+	Entry.FloorPrimitive	= FloorPrimitive;
+	Entry.SimTimeMs			= SimTimeMs;
+	Entry.ServerFrame		= ServerFrame;
+}
+
+void FFGFloorHistory::Reset()
+{
+	for(FEntry& Entry : Entries)
+	{
+		Entry.ServerFrame = INDEX_NONE;
+	}
+}
@@ -0,0 +1,274 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGInputProducer.h"
+#include "Core/FGDataModel.h"
+#include "Core/FGPawn.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/IConsoleManager.h"
+#include "Logging/StructuredLog.h"
+#include "Math/RandomStream.h"
+#include "MoverLog.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FGInputProducer)
+
+namespace FG::SyntheticInput
+{
+	/** @return A random stream for one stretch of a pawn's movement, the same every time for the same seed and stretch. */
+	static FRandomStream GetStream(int32 Seed, int32 Segment)
+	{
+		return FRandomStream(static_cast<int32>(HashCombine(GetTypeHash(Seed), GetTypeHash(Segment))));
+	}
+}
+
+void UFGSyntheticInputProducer::ProduceInput(AFGPawn& Pawn, int32 SimTimeMs, FFGMoverInputCmd& OutCmd)
+{
+	using namespace FG::SyntheticInput;
+
+	EFGSyntheticMovement PawnMovement = Movement;
+	if(PawnMovement == EFGSyntheticMovement::Mixed)
+	{
+		PawnMovement = static_cast<EFGSyntheticMovement>(GetStream(Seed, -1).RandHelper(static_cast<int32>(EFGSyntheticMovement::Mixed)));
+	}
+
+	FVector MoveInput = FVector::ZeroVector;
+	double Yaw = 0.0;
+	bool bJump = false;
+	bool bCrouch = false;
+	bool bSprint = false;
+
+	switch(PawnMovement)
+	{
+	case EFGSyntheticMovement::Wander:
+	{
+		const FRandomStream Stream = GetStream(Seed, SimTimeMs / 2000);
+		Yaw = Stream.FRandRange(-180.0f, 180.0f);
+		MoveInput = Stream.FRand() < 0.2f ? FVector::ZeroVector : FVector::ForwardVector;
+		bSprint = Stream.FRand() < 0.3f;
+		break;
+	}
+	case EFGSyntheticMovement::StrafeJump:
+	{
+		const int32 Swing = SimTimeMs / 500;
+		const double Side = (Swing & 1) ? 1.0 : -1.0;
+		const double SwingAlpha = (SimTimeMs % 500) / 500.0;
+
+		// New heading every 4 seconds, the view sweeps 60 degrees towards the strafe side on every swing.
+		Yaw = GetStream(Seed, Swing / 8).FRandRange(-180.0f, 180.0f) + Side * (SwingAlpha - 0.5) * 60.0;
+		MoveInput = FVector(1.0, Side, 0.0).GetSafeNormal();
+		bJump = true;
+		break;
+	}
+	case EFGSyntheticMovement::CrouchSpam:
+	{
+		Yaw = GetStream(Seed, SimTimeMs / 3000).FRandRange(-180.0f, 180.0f);
+		MoveInput = FVector::ForwardVector;
+		bCrouch = ((SimTimeMs / 250) & 1) != 0;
+		break;
+	}
+	case EFGSyntheticMovement::SurfRun:
+	{
+		const int32 Run = SimTimeMs / 6000;
+		const FRandomStream Stream = GetStream(Seed, Run);
+		const double Side = Stream.FRand() < 0.5f ? -1.0 : 1.0;
+
+		// Turn into the strafe side at 20 degrees per second, jumping on at the start of each run.
+		Yaw = Stream.FRandRange(-180.0f, 180.0f) + Side * 20.0 * ((SimTimeMs % 6000) * 0.001);
+		MoveInput = FVector(0.0, Side, 0.0);
+		bJump = (SimTimeMs % 6000) < 200;
+		break;
+	}
+	default:
+		break;
+	}
+
+	const FRotator ControlRotation(0.0, FRotator::NormalizeAxis(Yaw), 0.0);
+
+	OutCmd.ControlRotation = ControlRotation;
+	OutCmd.OrientationIntent = ControlRotation.Vector();
+	OutCmd.bUsingMovementBase = false;
+	OutCmd.bIsJumpPressed = bJump;
+	OutCmd.bIsCrouchPressed = bCrouch;
+	OutCmd.bIsSprintPressed = bSprint;
+	OutCmd.SetMoveInput(EMoveInputType::DirectionalIntent, MoveInput);
+}
+
+void UFGScriptedInputProducer::ProduceInput(AFGPawn& Pawn, int32 SimTimeMs, FFGMoverInputCmd& OutCmd)
+{
+	if(StartTimeMs == INDEX_NONE)
+	{
+		StartTimeMs = SimTimeMs;
+	}
+
+	// Past the end, stand still where the last step was looking.
+	FFGScriptedInputStep Step;
+	Step.Yaw = Steps.Num() > 0 ? Steps.Last().Yaw : 0.0f;
+
+	int32 StepEndMs = 0;
+	for(const FFGScriptedInputStep& Candidate : Steps)
+	{
+		StepEndMs += Candidate.DurationMs;
+		if(SimTimeMs - StartTimeMs < StepEndMs)
+		{
+			Step = Candidate;
+			break;
+		}
+	}
+
+	const FRotator ControlRotation(0.0, FRotator::NormalizeAxis(Step.Yaw), 0.0);
+
+	OutCmd.ControlRotation = ControlRotation;
+	OutCmd.OrientationIntent = ControlRotation.Vector();
+	OutCmd.bUsingMovementBase = false;
+	OutCmd.bIsJumpPressed = Step.bJump;
+	OutCmd.bIsCrouchPressed = Step.bCrouch;
+	OutCmd.bIsSprintPressed = Step.bSprint;
+	OutCmd.SetMoveInput(EMoveInputType::DirectionalIntent, Step.MoveInput);
+}
+
+int32 UFGScriptedInputProducer::GetDurationMs() const
+{
+	int32 DurationMs = 0;
+	for(const FFGScriptedInputStep& Step : Steps)
+	{
+		DurationMs += Step.DurationMs;
+	}
+	return DurationMs;
+}
+
+namespace FG::SyntheticInput
+{
+	static const FName SyntheticPawnTag(TEXT("FGSynthetic"));
+
+	TArray<AFGPawn*> SpawnPawns(UWorld& World, const FVector& Origin, int32 Count, EFGSyntheticMovement Movement, int32 Seed, float Spacing)
+	{
+		TArray<AFGPawn*> Pawns;
+		Pawns.Reserve(Count);
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+		// Square grid centered on the origin.
+		const int32 GridSize = FMath::Max(FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count))), 1);
+		const double HalfExtent = (GridSize - 1) * Spacing * 0.5;
+
+		for(int32 Idx = 0; Idx < Count; ++Idx)
+		{
+			const FVector Location = Origin + FVector((Idx % GridSize) * Spacing - HalfExtent, (Idx / GridSize) * Spacing - HalfExtent, 0.0);
+
+			AFGPawn* Pawn = World.SpawnActor<AFGPawn>(AFGPawn::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+			if(!Pawn)
+			{
+				continue;
+			}
+
+			UFGSyntheticInputProducer* Producer = NewObject<UFGSyntheticInputProducer>(Pawn);
+			Producer->Movement = Movement;
+			Producer->Seed = Seed + Idx;
+
+			Pawn->SetInputProducer(Producer);
+			Pawn->Tags.Add(SyntheticPawnTag);
+			Pawns.Add(Pawn);
+		}
+
+		return Pawns;
+	}
+
+	int32 DestroyPawns(UWorld& World)
+	{
+		int32 NumDestroyed = 0;
+		for(TActorIterator<AFGPawn> It(&World); It; ++It)
+		{
+			if(It->ActorHasTag(SyntheticPawnTag))
+			{
+				It->Destroy();
+				++NumDestroyed;
+			}
+		}
+		return NumDestroyed;
+	}
+
+	UWorld* FindAuthorityWorld()
+	{
+		for(const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if(World && World->IsGameWorld() && World->GetNetMode() != NM_Client)
+			{
+				return World;
+			}
+		}
+		return nullptr;
+	}
+
+	static FAutoConsoleCommand CmdSpawn(
+		TEXT("FG.Spawn.Synthetic"),
+		TEXT("Spawns FG pawns driven by seeded synthetic input on a grid around the first player start. Usage: FG.Spawn.Synthetic Count [Wander|StrafeJump|CrouchSpam|SurfRun|Mixed] [Seed] [Spacing]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			UWorld* World = FindAuthorityWorld();
+			if(!World || Args.Num() < 1)
+			{
+				UE_LOGFMT(LogMover, Warning, "FG.Spawn.Synthetic - Needs a count and a server or standalone world");
+				return;
+			}
+
+			int32 Count = 0;
+			int32 Seed = 0;
+			float Spacing = 200.0f;
+			EFGSyntheticMovement Movement = EFGSyntheticMovement::Mixed;
+
+			LexFromString(Count, *Args[0]);
+			if(Args.Num() > 1)
+			{
+				const int64 Value = StaticEnum<EFGSyntheticMovement>()->GetValueByNameString(Args[1]);
+				if(Value == INDEX_NONE)
+				{
+					UE_LOGFMT(LogMover, Warning, "FG.Spawn.Synthetic - Unknown movement {Movement}", Args[1]);
+					return;
+				}
+				Movement = static_cast<EFGSyntheticMovement>(Value);
+			}
+			if(Args.Num() > 2)
+			{
+				LexFromString(Seed, *Args[2]);
+			}
+			if(Args.Num() > 3)
+			{
+				LexFromString(Spacing, *Args[3]);
+			}
+
+			FVector Origin = FVector::ZeroVector;
+			for(TActorIterator<APlayerStart> It(World); It; ++It)
+			{
+				Origin = It->GetActorLocation();
+				break;
+			}
+
+			const int32 NumSpawned = SpawnPawns(*World, Origin, Count, Movement, Seed, Spacing).Num();
+			UE_LOGFMT(LogMover, Log, "FG.Spawn.Synthetic - Spawned {Num} pawns", NumSpawned);
+		}));
+
+	static FAutoConsoleCommand CmdClear(
+		TEXT("FG.Spawn.Clear"),
+		TEXT("Destroys every pawn spawned by FG.Spawn.Synthetic."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			UWorld* World = FindAuthorityWorld();
+			if(!World)
+			{
+				return;
+			}
+
+			UE_LOGFMT(LogMover, Log, "FG.Spawn.Clear - Destroyed {Num} pawns", DestroyPawns(*World));
+		}));
+}
@@ -0,0 +1,266 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGInputRecording.h"
+#include "Core/FGDataModel.h"
+#include "Core/FGMoverComponent.h"
+#include "Core/FGPawn.h"
+#include "FGMovementCVars.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "MoverLog.h"
+#include "UObject/UObjectIterator.h"
+
+FArchive& operator<<(FArchive& Ar, FFGInputSample& Sample)
+{
+	Ar << Sample.SimTimeMs;
+	Ar << Sample.Location;
+	Ar << Sample.MoveInput[0];
+	Ar << Sample.MoveInput[1];
+	Ar << Sample.MoveInput[2];
+	Ar << Sample.Buttons;
+	Ar << Sample.OrientationPitch;
+	Ar << Sample.OrientationYaw;
+	Ar << Sample.ControlPitch;
+	Ar << Sample.ControlYaw;
+	Ar << Sample.Mode;
+	Ar << Sample.Flags;
+	return Ar;
+}
+
+namespace FG::InputRecording
+{
+	static void SerializeTuning(FArchive& Ar, FFGMovementTuning& Tuning)
+	{
+		Ar << Tuning.GroundSpeed;
+		Ar << Tuning.AirSpeed;
+		Ar << Tuning.GroundDamping;
+		Ar << Tuning.AirDamping;
+		Ar << Tuning.GroundAcceleration;
+		Ar << Tuning.AirAcceleration;
+		Ar << Tuning.SlipFactor;
+		Ar << Tuning.GravitySpeed;
+		Ar << Tuning.JumpForce;
+		Ar << Tuning.CrouchSpeedMult;
+		Ar << Tuning.SprintSpeedMult;
+	}
+}
+
+void FFGInputRecording::Record(int32 SimTimeMs, const FVector& Location, EFGModeId Mode, const FFGMoverInputCmd& Cmd)
+{
+	if(Samples.IsEmpty())
+	{
+		StartSimTimeMs = SimTimeMs;
+	}
+
+	FFGInputSample& Sample = Samples.AddDefaulted_GetRef();
+	Sample.SimTimeMs	= SimTimeMs - StartSimTimeMs;
+	Sample.Location		= FVector3f(Location);
+	Sample.Mode			= static_cast<uint8>(Mode);
+	Sample.Pack(Cmd);
+}
+
+void FFGInputRecording::Serialize(FArchive& Ar)
+{
+	uint32 FileMagic = Magic;
+	uint32 FileVersion = Version;
+	uint32 NumSamples = Samples.Num();
+
+	Ar << FileMagic;
+	Ar << FileVersion;
+	Ar << NumSamples;
+
+	if(Ar.IsLoading() && (FileMagic != Magic || FileVersion != Version || int64(NumSamples) * SampleSize > Ar.TotalSize()))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	uint8 Mode = static_cast<uint8>(StartMode);
+
+	Ar << StartLocation;
+	Ar << StartRotation;
+	Ar << StartVelocity;
+	Ar << Mode;
+	FG::InputRecording::SerializeTuning(Ar, Tuning);
+
+	StartMode = static_cast<EFGModeId>(Mode);
+
+	if(Ar.IsLoading())
+	{
+		Samples.SetNum(NumSamples);
+	}
+
+	for(FFGInputSample& Sample : Samples)
+	{
+		Ar << Sample;
+	}
+}
+
+bool FFGInputRecording::SaveToFile(const FString& Path)
+{
+	TUniquePtr<FArchive> Writer = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*Path));
+	if(!Writer)
+	{
+		return false;
+	}
+
+	Serialize(*Writer);
+	return Writer->Close();
+}
+
+bool FFGInputRecording::LoadFromFile(const FString& Path)
+{
+	TUniquePtr<FArchive> Reader = TUniquePtr<FArchive>(IFileManager::Get().CreateFileReader(*Path));
+	if(!Reader)
+	{
+		return false;
+	}
+
+	Serialize(*Reader);
+	return !Reader->IsError();
+}
+
+void FFGInputReplay::Next(int32 SimTimeMs, const FVector& Location, FFGMoverInputCmd& OutCmd, const UObject* Owner)
+{
+	if(Cursor == 0)
+	{
+		StartSimTimeMs = SimTimeMs;
+	}
+
+	const FFGInputSample& Sample = Recording.Samples[Cursor];
+	Sample.Unpack(OutCmd);
+
+	// Different tick rates never line up, so only report the first one.
+	if(FirstTimingMismatch == INDEX_NONE && SimTimeMs - StartSimTimeMs != Sample.SimTimeMs)
+	{
+		FirstTimingMismatch = Cursor;
+		UE_LOGFMT(LogMover, Warning, "FG.Input.Replay - {Owner} is at {SimTimeMs}ms on cmd {Cmd}, it was recorded at {RecordedMs}ms. Is the sim tick rate the same?",
+			GetNameSafe(Owner), SimTimeMs - StartSimTimeMs, Cursor, Sample.SimTimeMs);
+	}
+
+	const float Error = FVector3f::Dist(FVector3f(Location), Sample.Location);
+	MaxError = FMath::Max(MaxError, Error);
+
+	if(FirstDivergence == INDEX_NONE && Error > FG::CVars::InputReplayTolerance)
+	{
+		FirstDivergence = Cursor;
+		UE_LOGFMT(LogMover, Warning, "FG.Input.Replay - {Owner} diverged by {Error}cm at cmd {Cmd} ({SimTimeMs}ms)",
+			GetNameSafe(Owner), Error, Cursor, Sample.SimTimeMs);
+	}
+
+	++Cursor;
+}
+
+void FFGInputReplay::Report(const UObject* Owner) const
+{
+	if(FirstDivergence == INDEX_NONE)
+	{
+		UE_LOGFMT(LogMover, Log, "FG.Input.Replay - {Owner} matched the recording over {Num} cmds, max error {Error}cm",
+			GetNameSafe(Owner), Cursor, MaxError);
+	}
+	else
+	{
+		UE_LOGFMT(LogMover, Warning, "FG.Input.Replay - {Owner} DIVERGED from cmd {First} of {Num}, max error {Error}cm",
+			GetNameSafe(Owner), FirstDivergence, Cursor, MaxError);
+	}
+}
+
+namespace FG::InputRecording
+{
+	static TArray<AFGPawn*> GatherPawns(const FString& Filter)
+	{
+		TArray<AFGPawn*> Pawns;
+		for(TObjectIterator<AFGPawn> It; It; ++It)
+		{
+			AFGPawn* Pawn = *It;
+			if(Pawn->IsTemplate() || !Pawn->GetWorld() || !Pawn->GetWorld()->IsGameWorld())
+			{
+				continue;
+			}
+
+			if(Filter.IsEmpty() || Filter == TEXT("all") || Pawn->GetName() == Filter)
+			{
+				Pawns.Add(Pawn);
+			}
+		}
+		return Pawns;
+	}
+
+	static FAutoConsoleCommand CmdRecord(
+		TEXT("FG.Input.Record"),
+		TEXT("Starts recording the input cmds of one FG pawn (by name) or all of them. Usage: FG.Input.Record [PawnName]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const TArray<AFGPawn*> Pawns = GatherPawns(Args.Num() > 0 ? Args[0] : FString());
+			for(AFGPawn* Pawn : Pawns)
+			{
+				Pawn->StartInputRecording();
+			}
+			UE_LOGFMT(LogMover, Log, "FG.Input.Record - Recording {Num} pawns", Pawns.Num());
+		}));
+
+	static FAutoConsoleCommand CmdStop(
+		TEXT("FG.Input.Stop"),
+		TEXT("Stops recording input and writes each recording to Saved/FGMovement. Usage: FG.Input.Stop [PawnName]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Timestamp = FDateTime::Now().ToString();
+			int32 NumWritten = 0;
+
+			for(AFGPawn* Pawn : GatherPawns(Args.Num() > 0 ? Args[0] : FString()))
+			{
+				if(!Pawn->IsRecordingInput())
+				{
+					continue;
+				}
+
+				const FString Path = FPaths::ProjectSavedDir() / TEXT("FGMovement") / FString::Printf(TEXT("Input_%s_%s.fgi"), *Pawn->GetName(), *Timestamp);
+				if(Pawn->StopInputRecording(Path))
+				{
+					UE_LOGFMT(LogMover, Log, "FG.Input.Stop - Wrote {Path}", Path);
+					++NumWritten;
+				}
+				else
+				{
+					UE_LOGFMT(LogMover, Error, "FG.Input.Stop - Couldn't write {Path}", Path);
+				}
+			}
+
+			UE_LOGFMT(LogMover, Log, "FG.Input.Stop - Wrote {Num} recordings", NumWritten);
+		}));
+
+	static FAutoConsoleCommand CmdReplay(
+		TEXT("FG.Input.Replay"),
+		TEXT("Replays a recording through an FG pawn (by name, or the first one found) and reports any divergence from the recorded trajectory. Usage: FG.Input.Replay File [PawnName]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if(Args.Num() < 1)
+			{
+				UE_LOGFMT(LogMover, Warning, "FG.Input.Replay - Usage: FG.Input.Replay File [PawnName]");
+				return;
+			}
+
+			const TArray<AFGPawn*> Pawns = GatherPawns(Args.Num() > 1 ? Args[1] : FString());
+			if(Pawns.IsEmpty())
+			{
+				UE_LOGFMT(LogMover, Warning, "FG.Input.Replay - No FG pawn to replay on");
+				return;
+			}
+
+			if(!Pawns[0]->StartInputReplay(Args[0]))
+			{
+				UE_LOGFMT(LogMover, Error, "FG.Input.Replay - Couldn't replay {Path}", Args[0]);
+			}
+		}));
+}
@@ -0,0 +1,63 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGMovementContext.h"
+#include "Core/FGDataModel.h"
+#include "Core/FGMovementUtils.h"
+#include "Core/FGMoverComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "MovementMode.h"
+#include "MoverSimulationTypes.h"
+
+namespace FG::Context
+{
+	static UFGMoverComponent& ResolveMover(const UBaseMovementMode& Mode)
+	{
+		return *CastChecked<UFGMoverComponent>(Mode.GetMoverComponent());
+	}
+
+	static const FFGMoverInputCmd& ResolveInput(const FMoverTickStartData& StartState)
+	{
+		static const FFGMoverInputCmd DefaultInput;
+
+		const FFGMoverInputCmd* Input = StartState.InputCmd.InputCollection.FindDataByType<FFGMoverInputCmd>();
+		return Input ? *Input : DefaultInput;
+	}
+
+	static const FFGMoverSyncState& ResolveSyncState(const FMoverTickStartData& StartState)
+	{
+		const FFGMoverSyncState* SyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FFGMoverSyncState>();
+		check(SyncState);
+		return *SyncState;
+	}
+}
+
+FFGMovementContext::FFGMovementContext(const UBaseMovementMode& Mode, const FMoverTickStartData& StartState)
+	: FFGMovementContext(FG::Context::ResolveMover(Mode), StartState)
+{}
+
+FFGMovementContext::FFGMovementContext(const UBaseMovementMode& Mode, const FSimulationTickParams& Params)
+	: FFGMovementContext(FG::Context::ResolveMover(Mode), Params.StartState, Params.UpdatedComponent, Params.UpdatedPrimitive)
+{}
+
+FFGMovementContext::FFGMovementContext(UFGMoverComponent& InMoverComp, const FMoverTickStartData& StartState)
+	: FFGMovementContext(InMoverComp, StartState, InMoverComp.GetUpdatedComponent(), Cast<UPrimitiveComponent>(InMoverComp.GetUpdatedComponent()))
+{}
+
+FFGMovementContext::FFGMovementContext(UFGMoverComponent& InMoverComp, const FMoverTickStartData& StartState,
+	USceneComponent* InUpdatedComponent, UPrimitiveComponent* InUpdatedPrimitive)
+	: MoverComp(InMoverComp)
+	, CostStats(MoverComp.GetCostStats())
+	, Input(FG::Context::ResolveInput(StartState))
+	, StartSyncState(FG::Context::ResolveSyncState(StartState))
+	, UpdatedComponent(InUpdatedComponent)
+	, UpdatedPrimitive(InUpdatedPrimitive)
+	, LastFloor(MoverComp.GetFloorCache().GetLastFloor())
+	, Tuning(FG::GetTuning(MoverComp))
+{}
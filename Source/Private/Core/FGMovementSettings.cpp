@@ -0,0 +1,90 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGMovementSettings.h"
+#include "FGMovementCVars.h"
+#include "HAL/IConsoleManager.h"
+#include <atomic>
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FGMovementSettings)
+
+FFGMovementTuning UFGMovementSettings::ToTuning() const
+{
+	FFGMovementTuning Tuning;
+	Tuning.GroundSpeed			= GroundSpeed;
+	Tuning.AirSpeed				= AirSpeed;
+	Tuning.GroundDamping		= GroundDamping;
+	Tuning.AirDamping			= AirDamping;
+	Tuning.GroundAcceleration	= GroundAcceleration;
+	Tuning.AirAcceleration		= AirAcceleration;
+	Tuning.SlipFactor			= SlipFactor;
+	Tuning.GravitySpeed			= GravitySpeed;
+	Tuning.JumpForce			= JumpForce;
+	Tuning.CrouchSpeedMult		= CrouchSpeedMult;
+	Tuning.SprintSpeedMult		= SprintSpeedMult;
+	return Tuning;
+}
+
+namespace FG::Tuning
+{
+	struct FCVarOverride
+	{
+		const TCHAR*				Name;
+		float FFGMovementTuning::*	Member;
+		const float*				Value;
+	};
+
+	static const FCVarOverride CVarOverrides[] =
+	{
+		{ TEXT("FG.Move.GroundSpeed"),			&FFGMovementTuning::GroundSpeed,		&FG::CVars::GroundSpeed },
+		{ TEXT("FG.Move.AirSpeed"),				&FFGMovementTuning::AirSpeed,			&FG::CVars::AirSpeed },
+		{ TEXT("FG.Move.GroundDamping"),		&FFGMovementTuning::GroundDamping,		&FG::CVars::GroundDamping },
+		{ TEXT("FG.Move.AirDamping"),			&FFGMovementTuning::AirDamping,			&FG::CVars::AirDamping },
+		{ TEXT("FG.Move.GroundAcceleration"),	&FFGMovementTuning::GroundAcceleration,	&FG::CVars::GroundAcceleration },
+		{ TEXT("FG.Move.AirAcceleration"),		&FFGMovementTuning::AirAcceleration,	&FG::CVars::AirAcceleration },
+		{ TEXT("FG.Move.SlipFactor"),			&FFGMovementTuning::SlipFactor,			&FG::CVars::SlipFactor },
+		{ TEXT("FG.Move.GravitySpeed"),			&FFGMovementTuning::GravitySpeed,		&FG::CVars::GravitySpeed },
+		{ TEXT("FG.Move.JumpForce"),			&FFGMovementTuning::JumpForce,			&FG::CVars::JumpForce },
+		{ TEXT("FG.Move.CrouchSpeedMult"),		&FFGMovementTuning::CrouchSpeedMult,	&FG::CVars::CrouchSpeedMult },
+		{ TEXT("FG.Move.SprintSpeedMult"),		&FFGMovementTuning::SprintSpeedMult,	&FG::CVars::SprintSpeedMult },
+	};
+
+	// One bit per CVarOverrides entry, so the common case of no overrides is a single load.
+	static std::atomic<uint32> OverrideMask { 0 };
+
+	void RefreshCVarOverrides()
+	{
+		uint32 Mask = 0;
+
+		for(int32 Idx = 0; Idx < UE_ARRAY_COUNT(CVarOverrides); ++Idx)
+		{
+			const IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(CVarOverrides[Idx].Name);
+			if(CVar && (CVar->GetFlags() & ECVF_SetByMask) != ECVF_SetByConstructor)
+			{
+				Mask |= 1u << Idx;
+			}
+		}
+
+		OverrideMask.store(Mask, std::memory_order_relaxed);
+	}
+
+	static FAutoConsoleVariableSink CVarOverrideSink(FConsoleCommandDelegate::CreateStatic(&RefreshCVarOverrides));
+
+	void ApplyCVarOverrides(FFGMovementTuning& Tuning)
+	{
+		uint32 Mask = OverrideMask.load(std::memory_order_relaxed);
+
+		while(Mask)
+		{
+			const FCVarOverride& Override = CVarOverrides[FMath::CountTrailingZeros(Mask)];
+			Tuning.*Override.Member = *Override.Value;
+			Mask &= Mask - 1;
+		}
+	}
+}
@@ -0,0 +1,129 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGMovementStats.h"
+#include "FGMovementCVars.h"
+#include "FGMovementDefines.h"
+#include "FGMovementTrace.h"
+#include "MoverDataModelTypes.h"
+#include "MoverLog.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/Crc.h"
+#include "Core/FGMoverComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+namespace FG::Stats
+{
+	// Rounded to 0.01 so float noise well below what gets replicated doesn't break the hash.
+	struct FTrajectorySample
+	{
+		int32 Location[3];
+		int32 Velocity[3];
+		int32 Mode;
+	};
+
+	static int32 QuantizeForHash(double Value)
+	{
+		return static_cast<int32>(FMath::RoundToDouble(Value * 100.0));
+	}
+}
+
+void FFGMoverCostStats::CommitTick(const FMoverDefaultSyncState& SyncState, EFGModeId ModeId, const UObject* Owner)
+{
+	const FVector Location = SyncState.GetLocation_WorldSpace();
+	const FVector Velocity = SyncState.GetVelocity_WorldSpace();
+
+	FG::Stats::FTrajectorySample Sample;
+	FMemory::Memzero(Sample);
+	Sample.Location[0] = FG::Stats::QuantizeForHash(Location.X);
+	Sample.Location[1] = FG::Stats::QuantizeForHash(Location.Y);
+	Sample.Location[2] = FG::Stats::QuantizeForHash(Location.Z);
+	Sample.Velocity[0] = FG::Stats::QuantizeForHash(Velocity.X);
+	Sample.Velocity[1] = FG::Stats::QuantizeForHash(Velocity.Y);
+	Sample.Velocity[2] = FG::Stats::QuantizeForHash(Velocity.Z);
+	Sample.Mode = static_cast<int32>(ModeId);
+
+	TrajectoryHash = FCrc::MemCrc32(&Sample, sizeof(Sample), TrajectoryHash);
+
+	const uint64 TickCycles = TickGenerateCycles + TickSimulateCycles;
+	const double TickUs = FPlatformTime::ToMilliseconds64(TickCycles) * 1000.0;
+
+	const bool bOverTimeBudget = FG::CVars::TickBudgetUs > 0.0f && TickUs > FG::CVars::TickBudgetUs;
+	const bool bOverSweepBudget = FG::CVars::TickSweepBudget > 0 && TickSweeps > static_cast<uint32>(FG::CVars::TickSweepBudget);
+
+	if(bOverTimeBudget || bOverSweepBudget)
+	{
+		++NumOverBudgetTicks;
+		UE_LOGFMT(LogMover, Warning, "{Owner} blew the FG tick budget in {Mode} - {TickUs}us / {BudgetUs}us, {Sweeps} / {BudgetSweeps} sweeps",
+			GetNameSafe(Owner), FG::Modes::ToName(ModeId), TickUs, FG::CVars::TickBudgetUs, TickSweeps, FG::CVars::TickSweepBudget);
+	}
+
+	FG::Trace::Count(FG::Trace::FrameCounters.SimTicks);
+
+	++NumTicks;
+	TotalSweeps += TickSweeps;
+	TotalGenerateCycles += TickGenerateCycles;
+	TotalSimulateCycles += TickSimulateCycles;
+
+	TickSweeps = 0;
+	TickGenerateCycles = 0;
+	TickSimulateCycles = 0;
+}
+
+namespace FG::Stats
+{
+	static FAutoConsoleCommand CmdTransitions(
+		TEXT("FG.Stats.Transitions"),
+		TEXT("Logs the Walk <-> Air transitions per simulated second of every FG mover, since its stats were last reset (FG.Golden.Reset)."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			for(TObjectIterator<UFGMoverComponent> It; It; ++It)
+			{
+				const UFGMoverComponent* Mover = *It;
+				if(Mover->IsTemplate() || !Mover->GetOwner() || !Mover->GetWorld() || !Mover->GetWorld()->IsGameWorld())
+				{
+					continue;
+				}
+
+				const FFGMoverCostStats& Stats = Mover->GetCostStats();
+				UE_LOGFMT(LogMover, Log, "FG.Stats.Transitions - {Owner}: {Num} Walk <-> Air in {Seconds}s, {Rate}/s",
+					Mover->GetOwner()->GetName(), Stats.NumWalkAirTransitions, Stats.SimSeconds, Stats.GetWalkAirTransitionsPerSecond());
+			}
+		}));
+
+	static FAutoConsoleCommand CmdResim(
+		TEXT("FG.Stats.Resim"),
+		TEXT("Logs how many ticks every FG mover replayed after corrections, and how many floors the floor history answered, since its stats were last reset (FG.Golden.Reset)."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			for(TObjectIterator<UFGMoverComponent> It; It; ++It)
+			{
+				const UFGMoverComponent* Mover = *It;
+				if(Mover->IsTemplate() || !Mover->GetOwner() || !Mover->GetWorld() || !Mover->GetWorld()->IsGameWorld())
+				{
+					continue;
+				}
+
+				const FFGMoverCostStats& Stats = Mover->GetCostStats();
+				UE_LOGFMT(LogMover, Log, "FG.Stats.Resim - {Owner}: {Resim} of {Ticks} ticks replayed, {Hits} floors from history",
+					Mover->GetOwner()->GetName(), Stats.NumResimTicks, Stats.NumTicks, Stats.NumFloorHistoryHits);
+			}
+		}));
+}
+
+double FFGMoverCostStats::GetAverageTickUs() const
+{
+	if(NumTicks == 0)
+	{
+		return 0.0;
+	}
+	return FPlatformTime::ToMilliseconds64(TotalGenerateCycles + TotalSimulateCycles) * 1000.0 / NumTicks;
+}
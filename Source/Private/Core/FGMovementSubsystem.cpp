@@ -0,0 +1,115 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGMovementSubsystem.h"
+#include "Core/FGMoverComponent.h"
+#include "FGMovementCVars.h"
+#include "FGMovementTrace.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeExit.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FGMovementSubsystem)
+
+void UFGMovementSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	++FrameNumber;
+
+	if(!FG::CVars::ParallelFloorBatch)
+	{
+		return;
+	}
+
+	const int32 NumTasks = FG::CVars::ParallelTasks > 0 ? FG::CVars::ParallelTasks : FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+	PrefetchFloors(Movers.Num(), NumTasks);
+}
+
+TStatId UFGMovementSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFGMovementSubsystem, STATGROUP_Tickables);
+}
+
+bool UFGMovementSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFGMovementSubsystem::RegisterMover(UFGMoverComponent* Mover)
+{
+	Movers.AddUnique(Mover);
+}
+
+void UFGMovementSubsystem::UnregisterMover(UFGMoverComponent* Mover)
+{
+	Movers.RemoveSwap(Mover);
+}
+
+const TArray<FVector>& UFGMovementSubsystem::GetViewLocations()
+{
+	if(ViewLocationsFrame == GFrameCounter)
+	{
+		return ViewLocations;
+	}
+	ViewLocationsFrame = GFrameCounter;
+	ViewLocations.Reset();
+
+	for(FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if(!PlayerController || !PlayerController->IsLocalController())
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		ViewLocations.Add(ViewLocation);
+	}
+
+	return ViewLocations;
+}
+
+void UFGMovementSubsystem::PrefetchFloors(int32 NumMovers, int32 NumTasks)
+{
+	FG_SCOPE_CYCLE(UFGMovementSubsystem::PrefetchFloors);
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	ON_SCOPE_EXIT
+	{
+		TotalPrefetchCycles += FPlatformTime::Cycles64() - StartCycles;
+	};
+
+	NumMovers = FMath::Min(NumMovers, Movers.Num());
+	NumTasks = FMath::Clamp(NumTasks, 1, NumMovers);
+
+	if(NumTasks <= 1)
+	{
+		for(int32 Idx = 0; Idx < NumMovers; ++Idx)
+		{
+			Movers[Idx]->PrefetchFloor();
+		}
+		return;
+	}
+
+	// One contiguous slice per task, so NumTasks is also the most workers that run at once.
+	ParallelFor(NumTasks, [this, NumMovers, NumTasks](int32 TaskIdx)
+	{
+		const int32 Begin = (NumMovers * TaskIdx) / NumTasks;
+		const int32 End = (NumMovers * (TaskIdx + 1)) / NumTasks;
+
+		for(int32 Idx = Begin; Idx < End; ++Idx)
+		{
+			Movers[Idx]->PrefetchFloor();
+		}
+	});
+}
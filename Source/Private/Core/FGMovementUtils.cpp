@@ -13,82 +13,185 @@
 #include "MoveLibrary/MovementUtilsTypes.h"
 #include "MoverComponent.h"
 #include "Core/FGMoverComponent.h"
-#include "Kismet/KismetMathLibrary.h"
+#include "Core/FGMovementStats.h"
+#include "Core/FGMovementSettings.h"
+#include "MoveLibrary/FloorQueryUtils.h"
 #include "Logging/StructuredLog.h"
 #include "MoveLibrary/MovementUtils.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FGMovementUtils)
 
-void UFGMovementUtils::ApplyDamping(UFGMoverComponent* MoverComponent, FProposedMove& Move, float DeltaTime)
+FFGMovementTuning FG::GetTuning(const UFGMoverComponent& MoverComponent)
+{
+	FFGMovementTuning Tuning = MoverComponent.GetTuning();
+	if(MoverComponent.AppliesTuningOverrides())
+	{
+		FG::Tuning::ApplyCVarOverrides(Tuning);
+	}
+	return Tuning;
+}
+
+EFGMoveSurface FG::GetMoveSurface(const UFGMoverComponent* MoverComponent)
 {
-	double Damper = 0.0;
-	double IntentSpeed = 0.0;
-	
-	double Speed = Move.LinearVelocity.Size();
-	
 	if(MoverComponent->IsOnGround())
 	{
-		IntentSpeed = FG::CVars::GroundSpeed;
-		Damper = FG::CVars::GroundDamping;
+		return EFGMoveSurface::Ground;
 	}
-	else if(MoverComponent->IsAirborne())
+	else if(MoverComponent->IsAirborne() || MoverComponent->IsSurfing())
 	{
-		IntentSpeed = FG::CVars::AirSpeed;
-		Damper = FG::CVars::AirDamping;
+		return EFGMoveSurface::Air;
 	}
-	
-	double DragFactor = UKismetMathLibrary::NormalizeToRange(FMath::Max(FG::CVars::SlipFactor, Speed), 0.0, IntentSpeed);
-	double Drag = Damper * DragFactor; // Drag is a function of speed and the damper.
-	
-	Move.LinearVelocity += -Move.LinearVelocity * Drag * DeltaTime; // Apply counter force.
+	return EFGMoveSurface::None;
 }
 
-void UFGMovementUtils::ApplyAcceleration(UFGMoverComponent* MoverComponent, FProposedMove& Move, float DeltaTime, FVector DirectionIntent, float DesiredSpeed)
+void FG::FindFloor(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+	float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, FFloorCheckResult& OutFloorResult)
 {
-	double AccelerationConstant = 0.0;
+	FG_SCOPE_CYCLE(FG::FindFloor);
+	FG::Trace::Count(FG::Trace::FrameCounters.Sweeps);
 
-	if(MoverComponent->IsOnGround())
+	++Stats.TickSweeps;
+	UFloorQueryUtils::FindFloor(UpdatedComponent, UpdatedPrimitive, FloorSweepDistance, MaxWalkSlopeCosine, Location, OutFloorResult);
+}
+
+bool FG::TrySafeMoveUpdatedComponent(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+	const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult& OutHit, ETeleportType Teleport, FMovementRecord& MoveRecord)
+{
+	FG_SCOPE_CYCLE(FG::TrySafeMoveUpdatedComponent);
+	FG::Trace::Count(FG::Trace::FrameCounters.Sweeps, bSweep ? 1 : 0);
+
+	Stats.TickSweeps += bSweep ? 1 : 0;
+	return UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, Delta, NewRotation, bSweep, OutHit, Teleport, MoveRecord);
+}
+
+namespace FG::Slide
+{
+	// Most planes a single slide can remember, FG.Slide.MaxPlanes is clamped to this.
+	constexpr int32 MaxPlanesCapacity = 8;
+
+	// How far into a plane a delta may point and still count as sliding along it.
+	constexpr double PlaneTolerance = UE_KINDA_SMALL_NUMBER;
+
+	static FVector ClipToPlane(const FVector& Delta, const FVector& Normal)
 	{
-		AccelerationConstant = FG::CVars::GroundAcceleration;
+		return Delta - Normal * (Delta | Normal);
 	}
-	else if(MoverComponent->IsAirborne())
+
+	static bool IsIntoPlane(const FVector& Delta, const FVector& Normal)
 	{
-		AccelerationConstant = FG::CVars::AirAcceleration;
+		return (Delta | Normal) < -PlaneTolerance;
 	}
-	
-	const double Acceleration = DesiredSpeed * AccelerationConstant * DeltaTime;
-	const FVector DesiredVelocity = DirectionIntent * DesiredSpeed;
 
-	const double ProjectedCurrentVelocity = Move.LinearVelocity | DirectionIntent;
-	const double MissingSpeed = FMath::Max(DesiredSpeed - ProjectedCurrentVelocity, 0.0);
-	const double ScaledAcceleration = Acceleration * (MissingSpeed / DesiredSpeed);
-	
-	Move.LinearVelocity += DirectionIntent * ScaledAcceleration;
+	/** Clip a delta so it moves into none of the planes - along one plane, along the crease of two, or not at all in a corner. */
+	static FVector ClipToPlanes(const FVector& Delta, const FVector* Planes, int32 NumPlanes)
+	{
+		for(int32 PlaneIdx = 0; PlaneIdx < NumPlanes; ++PlaneIdx)
+		{
+			if(!IsIntoPlane(Delta, Planes[PlaneIdx]))
+			{
+				continue;
+			}
+
+			FVector Clipped = ClipToPlane(Delta, Planes[PlaneIdx]);
 
-	if(FG::CVars::DrawMovementDebug)
+			for(int32 OtherIdx = 0; OtherIdx < NumPlanes; ++OtherIdx)
+			{
+				if(OtherIdx == PlaneIdx || !IsIntoPlane(Clipped, Planes[OtherIdx]))
+				{
+					continue;
+				}
+
+				// Clipping against one pushes us into the other, follow the crease between them.
+				const FVector Crease = (Planes[PlaneIdx] ^ Planes[OtherIdx]).GetSafeNormal();
+				Clipped = Crease * (Crease | Delta);
+
+				for(int32 ThirdIdx = 0; ThirdIdx < NumPlanes; ++ThirdIdx)
+				{
+					if(ThirdIdx != PlaneIdx && ThirdIdx != OtherIdx && IsIntoPlane(Clipped, Planes[ThirdIdx]))
+					{
+						return FVector::ZeroVector; // Boxed into a corner.
+					}
+				}
+				break;
+			}
+
+			return Clipped;
+		}
+
+		return Delta;
+	}
+}
+
+int32 FG::SlideAlongSurfaces(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+	const FVector& Delta, const FQuat& Rotation, FHitResult& Hit, FMovementRecord& MoveRecord)
+{
+	FG_SCOPE_CYCLE(FG::SlideAlongSurfaces);
+
+	if(!Hit.bBlockingHit)
 	{
-		auto* MoverComp = Cast<UFGMoverComponent>(MoverComponent);
-		
-		// Draw desired velocity.
-		DrawDebugLine(
-			MoverComp->GetWorld(),
-			MoverComp->GetFeetLocation(),
-			MoverComp->GetFeetLocation() + DesiredVelocity,
-			FColor::Green,
-			false,
-			-1,
-			0,
-			1.0f);
-		
-		// Draw final velocity.
-		DrawDebugLine(
-			MoverComp->GetWorld(),
-			MoverComp->GetFeetLocation(),
-			MoverComp->GetFeetLocation() + Move.LinearVelocity,
-			FColor::Emerald,
-			false,
-			-1,
-			0,
-			1.0f);
+		return 0;
 	}
+
+	const int32 MaxPlanes = FMath::Clamp(FG::CVars::SlideMaxPlanes, 1, FG::Slide::MaxPlanesCapacity);
+	const int32 MaxSweeps = FMath::Max(FG::CVars::SlideMaxSweeps, 0);
+
+	FVector Planes[FG::Slide::MaxPlanesCapacity];
+	int32 NumPlanes = 0;
+	Planes[NumPlanes++] = Hit.Normal;
+
+	FVector Remaining = Delta * (1.0 - Hit.Time);
+	int32 NumSweeps = 0;
+
+	while(NumSweeps < MaxSweeps)
+	{
+		const FVector SlideDelta = FG::Slide::ClipToPlanes(Remaining, Planes, NumPlanes);
+
+		// Sliding back against the original move is what makes movers jitter in corners.
+		if(SlideDelta.IsNearlyZero() || (SlideDelta | Delta) <= 0.0)
+		{
+			break;
+		}
+
+		UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, SlideDelta, Rotation, true, Hit, ETeleportType::None, MoveRecord);
+		++NumSweeps;
+
+		if(!Hit.bBlockingHit)
+		{
+			break;
+		}
+
+		Remaining = SlideDelta * (1.0 - Hit.Time);
+
+		bool bKnownPlane = false;
+		for(int32 PlaneIdx = 0; PlaneIdx < NumPlanes && !bKnownPlane; ++PlaneIdx)
+		{
+			bKnownPlane = Planes[PlaneIdx].Equals(Hit.Normal, 1e-3);
+		}
+
+		if(!bKnownPlane)
+		{
+			if(NumPlanes == MaxPlanes)
+			{
+				break;
+			}
+			Planes[NumPlanes++] = Hit.Normal;
+		}
+	}
+
+	Stats.TickSweeps += NumSweeps;
+	Stats.MaxSlideSweeps = FMath::Max<uint32>(Stats.MaxSlideSweeps, NumSweeps);
+
+	FG::Trace::Count(FG::Trace::FrameCounters.Sweeps, NumSweeps);
+	FG::Trace::Count(FG::Trace::FrameCounters.SlideIterations, NumSweeps);
+	return NumSweeps;
+}
+
+void UFGMovementUtils::ApplyDamping(UFGMoverComponent* MoverComponent, FProposedMove& Move, float DeltaTime)
+{
+	FG::Kinematics::ApplyDamping(Move.LinearVelocity, FG::GetTuning(*MoverComponent), FG::GetMoveSurface(MoverComponent), DeltaTime);
+}
+
+void UFGMovementUtils::ApplyAcceleration(UFGMoverComponent* MoverComponent, FProposedMove& Move, float DeltaTime, FVector DirectionIntent, float DesiredSpeed)
+{
+	FG::Kinematics::ApplyAcceleration(Move.LinearVelocity, FG::GetTuning(*MoverComponent), FG::GetMoveSurface(MoverComponent), DeltaTime, DirectionIntent, DesiredSpeed);
 }
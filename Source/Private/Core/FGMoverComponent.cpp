@@ -10,12 +10,20 @@
 #include "Core/FGMoverComponent.h"
 #include "Modes/FGWalkMode.h"
 #include "Modes/FGAirMode.h"
+#include "Modes/FGSurfMode.h"
+#include "Modes/FGModeTick.h"
+#include "Core/FGDataModel.h"
+#include "Core/FGMovementSettings.h"
+#include "Core/FGMovementSubsystem.h"
+#include "Core/FGNetworkPredictionLiaison.h"
+#include "Core/FGPooledAllocator.h"
 #include "FGMovementDefines.h"
 #include "Components/CapsuleComponent.h"
 #include "Logging/StructuredLog.h"
 #include "MoveLibrary/FloorQueryUtils.h"
-#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
 #include "FGMovementCVars.h" 
+#include "FGMovementTrace.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FGMoverComponent)
 
@@ -25,7 +33,24 @@ UFGMoverComponent::UFGMoverComponent()
 	MovementModes.Reset();
 	MovementModes.Add(FG::Modes::Walk, CreateDefaultSubobject<UFGWalkMode>(TEXT("FGWalkMode")));
 	MovementModes.Add(FG::Modes::Air, CreateDefaultSubobject<UFGAirMode>(TEXT("FGAirMode")));
+	MovementModes.Add(FG::Modes::Surf, CreateDefaultSubobject<UFGSurfMode>(TEXT("FGSurfMode")));
 	StartingMovementMode = FG::Modes::Air;
+
+	// Network Prediction drives the simulation, the component tick only picks proxy LODs -
+	// see BeginPlay. Debug drawing lives in UFGMovementDebugSubsystem.
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	// Scopes input delta compression to each input RPC, see FFGMoverInputCmd.
+	BackendClass = UFGNetworkPredictionLiaison::StaticClass();
+
+	// Swap the default sync state for the quantized FG one.
+	for(FMoverDataPersistence& PersistentType : PersistentSyncStateDataTypes)
+	{
+		if(PersistentType.RequiredType == FMoverDefaultSyncState::StaticStruct())
+		{
+			PersistentType.RequiredType = FFGMoverSyncState::StaticStruct();
+		}
+	}
 }
 
 FVector UFGMoverComponent::GetFeetLocation()
@@ -37,80 +62,274 @@ FVector UFGMoverComponent::GetFeetLocation()
 	return FVector::ZeroVector;
 }
 
-void UFGMoverComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+namespace FG::LOD
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	static std::atomic<int32>& GetProxyCounter(EFGProxyLOD LOD)
+	{
+		switch(LOD)
+		{
+		case EFGProxyLOD::Reduced:	return FG::Trace::FrameCounters.ProxiesReduced;
+		case EFGProxyLOD::Minimal:	return FG::Trace::FrameCounters.ProxiesMinimal;
+		default:					return FG::Trace::FrameCounters.ProxiesFull;
+		}
+	}
+
+}
+
+void UFGMoverComponent::BeginPlay()
+{
+	SetMovementSettings(MovementSettings);
+
+	Super::BeginPlay();
+	FG::Trace::Count(FG::Trace::FrameCounters.NumMovers);
+
+	// Only clients have simulated proxies to pick a LOD for, servers and standalone games don't need to tick at all.
+	SetComponentTickEnabled(GetNetMode() == NM_Client);
+
+	MovementSubsystem = GetWorld()->GetSubsystem<UFGMovementSubsystem>();
+	if(MovementSubsystem)
+	{
+		MovementSubsystem->RegisterMover(this);
+	}
+
+	if(UPrimitiveComponent* UpdatedPrimitive = Cast<UPrimitiveComponent>(UpdatedComponent))
+	{
+		UpdatedPrimitive->OnComponentBeginOverlap.AddDynamic(this, &UFGMoverComponent::OnUpdatedPrimitiveBeginOverlap);
+	}
+}
+
+void UFGMoverComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(bCountedAsProxy)
+	{
+		FG::Trace::Count(FG::LOD::GetProxyCounter(ProxyLOD), -1);
+		bCountedAsProxy = false;
+	}
+
+	if(UPrimitiveComponent* UpdatedPrimitive = Cast<UPrimitiveComponent>(UpdatedComponent))
+	{
+		UpdatedPrimitive->OnComponentBeginOverlap.RemoveDynamic(this, &UFGMoverComponent::OnUpdatedPrimitiveBeginOverlap);
+	}
+
+	if(MovementSubsystem)
+	{
+		MovementSubsystem->UnregisterMover(this);
+		MovementSubsystem = nullptr;
+	}
+
+	FG::Trace::Count(FG::Trace::FrameCounters.NumMovers, -1);
+	Super::EndPlay(EndPlayReason);
+}
+
+void UFGMoverComponent::OnUpdatedPrimitiveBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+	int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	// Something walked into us, it may push us around.
+	WakeFromRest();
+}
+
+void UFGMoverComponent::UpdateProxyLOD()
+{
+	// Roles can change after BeginPlay, so keep the per LOD counters in step here.
+	const bool bIsProxy = GetOwnerRole() == ROLE_SimulatedProxy;
+	if(bIsProxy != bCountedAsProxy)
+	{
+		FG::Trace::Count(FG::LOD::GetProxyCounter(ProxyLOD), bIsProxy ? 1 : -1);
+		bCountedAsProxy = bIsProxy;
+	}
+
+	if(!bIsProxy || !FG::CVars::ProxyLODEnabled)
+	{
+		SetProxyLOD(EFGProxyLOD::Full);
+		return;
+	}
 
-#if ENABLE_DRAW_DEBUG
-	if(FG::CVars::DrawMovementDebug)
+	UFGMovementSubsystem* Subsystem = GetWorld()->GetSubsystem<UFGMovementSubsystem>();
+	if(!Subsystem)
 	{
-		FFloorCheckResult LastFloorResult;
-		GetSimBlackboard()->TryGet(CommonBlackboard::LastFloorResult, LastFloorResult);
+		return;
+	}
+
+	// Distance to the closest local viewpoint, split screen can have several.
+	const FVector Location = GetOwner()->GetActorLocation();
+	double ClosestDistSq = TNumericLimits<double>::Max();
+
+	for(const FVector& ViewLocation : Subsystem->GetViewLocations())
+	{
+		ClosestDistSq = FMath::Min(ClosestDistSq, FVector::DistSquared(Location, ViewLocation));
+	}
+
+	const bool bVisible = GetOwner()->WasRecentlyRendered(FG::CVars::ProxyLODOffscreenTime);
 
-		bool TouchingCollision = LastFloorResult.bWalkableFloor;
+	EFGProxyLOD NewLOD = EFGProxyLOD::Minimal;
+	if(bVisible && ClosestDistSq < FMath::Square(FG::CVars::ProxyLODNearDistance))
+	{
+		NewLOD = EFGProxyLOD::Full;
+	}
+	else if(bVisible && ClosestDistSq < FMath::Square(FG::CVars::ProxyLODFarDistance))
+	{
+		NewLOD = EFGProxyLOD::Reduced;
+	}
 
-		FQuat PlaneRot = LastFloorResult.bWalkableFloor ?	
-			LastFloorResult.HitResult.ImpactNormal.ToOrientationQuat() :
-			FVector::UpVector.ToOrientationQuat();
+	SetProxyLOD(NewLOD);
+}
 
-		// Draw floor plane.
-		DrawDebugBox(
-			GetWorld(),
-			GetFeetLocation(),
-			FVector(0.0f, 50.0f, 50.0f),
-			PlaneRot,
-			TouchingCollision ? FColor::Green : FColor::Red,
-			false,
-			-1,
-			0,
-			1.0f);
+void UFGMoverComponent::SetProxyLOD(EFGProxyLOD NewLOD)
+{
+	if(NewLOD == ProxyLOD)
+	{
+		return;
+	}
 
-		if(LastFloorResult.bWalkableFloor)
+	if(bCountedAsProxy)
+	{
+		FG::Trace::Count(FG::LOD::GetProxyCounter(ProxyLOD), -1);
+		FG::Trace::Count(FG::LOD::GetProxyCounter(NewLOD));
+	}
+
+	// Nobody is close enough to care about a lowered proxy's overlaps, and they're the bulk
+	// of the cost of moving it.
+	if(UPrimitiveComponent* UpdatedPrimitive = Cast<UPrimitiveComponent>(UpdatedComponent))
+	{
+		if(ProxyLOD == EFGProxyLOD::Full)
+		{
+			bRestoreOverlapEvents = UpdatedPrimitive->GetGenerateOverlapEvents();
+			UpdatedPrimitive->SetGenerateOverlapEvents(false);
+		}
+		else if(NewLOD == EFGProxyLOD::Full)
 		{
-			// Draw floor normal.
-			DrawDebugLine(
-				GetWorld(),
-				GetFeetLocation(),
-				GetFeetLocation() + LastFloorResult.HitResult.ImpactNormal * 50.f,
-				FColor::Blue,
-				false,
-				-1,
-				0,
-				1.0f);
+			UpdatedPrimitive->SetGenerateOverlapEvents(bRestoreOverlapEvents);
 		}
+	}
+
+	ProxyLOD = NewLOD;
+}
 
-		// Draw per frame velocity.
-		DrawDebugLine(
-			GetWorld(),
-			GetFeetLocation(),
-			GetFeetLocation() + (GetVelocity() * DeltaTime),
-			FColor::White,
-			false,
-			-1,
-			0,
-			1.0f);
+void UFGMoverComponent::FinalizeSmoothingFrame(const FMoverSyncState* SyncState, const FMoverAuxStateContext* AuxState)
+{
+	// Minimal proxies are far or offscreen, so they only pick up the interpolated state every
+	// so often, the rest of the frames leave the updated component - and everything attached
+	// to it - where it is. Anything closer is interpolated every frame so it doesn't stutter.
+	if(ProxyLOD == EFGProxyLOD::Minimal)
+	{
+		const double Now = GetWorld()->GetTimeSeconds();
+		if(Now - LastSmoothingFrameTime < FG::CVars::ProxyLODMinimalInterval)
+		{
+			return;
+		}
+		LastSmoothingFrameTime = Now;
 	}
-#endif
 
-	UE_LOGFMT(LogMover, Display, "Current Movement Mode - {Name}", GetMovementModeName());
-	UE_LOGFMT(LogMover, Display, "IsOnGround - {Grounded}", IsOnGround());
+	Super::FinalizeSmoothingFrame(SyncState, AuxState);
 }
 
-bool UFGMoverComponent::IsAirborne() const
+void UFGMoverComponent::RestoreFrame(const FMoverSyncState* SyncState, const FMoverAuxStateContext* AuxState)
+{
+	// Rollbacks copy the whole sync state, layered moves and all.
+	FG_SCOPE_TICK_ALLOCATIONS();
+	Super::RestoreFrame(SyncState, AuxState);
+
+	// Cast from a state we just threw away.
+	BallisticArc.Invalidate();
+}
+
+void UFGMoverComponent::SimulationTick(const FMoverTimeStep& InTimeStep, const FMoverTickStartData& SimInput, OUT FMoverTickEndData& SimOutput)
 {
-	if (bHasValidCachedState)
+	// Scoped around the whole Mover tick rather than the FG modes, so the state copies and
+	// layered move clones Mover makes around them are tagged as well.
+	FG_SCOPE_TICK_ALLOCATIONS();
+	Super::SimulationTick(InTimeStep, SimInput, SimOutput);
+}
+
+void UFGMoverComponent::SetMovementSettings(UFGMovementSettings* NewSettings)
+{
+	MovementSettings = NewSettings;
+	Tuning = MovementSettings ? MovementSettings->ToTuning() : FFGMovementTuning();
+	bApplyTuningOverrides = true;
+}
+
+void UFGMoverComponent::SetTuning(const FFGMovementTuning& NewTuning, bool bApplyCVarOverrides)
+{
+	Tuning = NewTuning;
+	bApplyTuningOverrides = bApplyCVarOverrides;
+}
+
+void UFGMoverComponent::NotifySimulationTick(const FMoverTimeStep& TimeStep)
+{
+	// Mode changes can run several ticks for the newest frame, so only older frames count as replays.
+	bResimulating = TimeStep.ServerFrame < LatestSimFrame;
+	LatestSimFrame = FMath::Max(LatestSimFrame, TimeStep.ServerFrame);
+
+	if(bResimulating)
 	{
-		return CachedLastSyncState.MovementMode == FG::Modes::Air;
+		++CostStats.NumResimTicks;
+		FG::Trace::Count(FG::Trace::FrameCounters.ResimTicks);
 	}
-	return false;
 }
 
-bool UFGMoverComponent::IsOnGround() const
+uint64 UFGMoverComponent::GetMovementFrame() const
 {
-	if (bHasValidCachedState)
+	return MovementSubsystem ? MovementSubsystem->GetFrameNumber() : 0;
+}
+
+void UFGMoverComponent::PrefetchFloor()
+{
+	// Proxies don't simulate, and resting movers or movers following an arc don't look for the floor.
+	if(!bHasValidCachedState || GetOwnerRole() == ROLE_SimulatedProxy || IsResting() || BallisticArc.IsValid())
 	{
-		return CachedLastSyncState.MovementMode == FG::Modes::Walk;
+		return;
 	}
 
+	// Nothing under us last tick, the sweep would most likely miss again and misses aren't kept.
+	const FFloorCheckResult* LastFloor = FloorCache.GetLastFloor();
+	if(LastFloor && !LastFloor->bBlockingHit)
+	{
+		return;
+	}
+
+	if(UPrimitiveComponent* UpdatedPrimitive = Cast<UPrimitiveComponent>(UpdatedComponent))
+	{
+		FloorCache.Prefetch(CostStats, UpdatedComponent, UpdatedPrimitive, FG::ModeTick::FloorSweepDist, FG::ModeTick::MaxWalkSlopeCosine,
+			UpdatedPrimitive->GetComponentLocation(), GetMovementFrame());
+	}
+}
+
+void UFGMoverComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdateProxyLOD();
+}
+
+bool UFGMoverComponent::IsResting() const
+{
+	if(bHasValidCachedState)
+	{
+		if(const FFGMoverSyncState* SyncState = CachedLastSyncState.SyncStateCollection.FindDataByType<FFGMoverSyncState>())
+		{
+			return RestState.IsResting(*SyncState);
+		}
+	}
 	return false;
 }
+
+EFGModeId UFGMoverComponent::GetModeId() const
+{
+	// Mover replicates the mode name itself, the id is only a cheaper way to look at it.
+	return bHasValidCachedState ? FG::Modes::ToId(CachedLastSyncState.MovementMode) : EFGModeId::None;
+}
+
+bool UFGMoverComponent::IsAirborne() const
+{
+	return GetModeId() == EFGModeId::Air;
+}
+
+bool UFGMoverComponent::IsOnGround() const
+{
+	return GetModeId() == EFGModeId::Walk;
+}
+
+bool UFGMoverComponent::IsSurfing() const
+{
+	return GetModeId() == EFGModeId::Surf;
+}
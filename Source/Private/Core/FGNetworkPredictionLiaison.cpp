@@ -0,0 +1,34 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "Core/FGNetworkPredictionLiaison.h"
+#include "Core/FGDataModel.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FGNetworkPredictionLiaison)
+
+bool UFGNetworkPredictionLiaison::CallRemoteFunction(UFunction* Function, void* Parms, FOutParmRec* OutParms, FFrame* Stack)
+{
+	// RPC parameters are serialized right here, while the batch is open.
+	FG::Net::FScopedInputBatch InputBatch;
+	return Super::CallRemoteFunction(Function, Parms, OutParms, Stack);
+}
+
+void UFGNetworkPredictionLiaison::ProcessEvent(UFunction* Function, void* Parms)
+{
+	// The server reads the cmds out of the RPC's parameters in its _Implementation.
+	if(Function && Function->HasAnyFunctionFlags(FUNC_Net))
+	{
+		FG::Net::FScopedInputBatch InputBatch;
+		Super::ProcessEvent(Function, Parms);
+		return;
+	}
+
+	Super::ProcessEvent(Function, Parms);
+}
@@ -10,11 +10,15 @@
 #include "Core/FGPawn.h"
 #include "Core/FGMoverComponent.h"
 #include "Core/FGDataModel.h"
+#include "Core/FGMovementUtils.h"
+#include "Core/FGInputProducer.h"
+#include "InstantEffects/FGInstantEffect_RestoreState.h"
 #include "FGMovementDefines.h"
 #include "InputMappingContext.h"
 #include "Components/CapsuleComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Logging/StructuredLog.h"
+#include "MoverLog.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FGPawn)
 
@@ -90,12 +94,121 @@ void AFGPawn::CrouchCompleted()
 	CrouchButtonDown = false;
 }
 
+void AFGPawn::Sprint()
+{
+	SprintButtonDown = true;
+}
+
+void AFGPawn::SprintCompleted()
+{
+	SprintButtonDown = false;
+}
+
+void AFGPawn::StartInputRecording()
+{
+	InputRecording = MakeUnique<FFGInputRecording>();
+	InputRecording->StartLocation = GetActorLocation();
+	InputRecording->StartRotation = GetActorRotation();
+	InputRecording->StartVelocity = MoverComponent->GetVelocity();
+	InputRecording->StartMode = MoverComponent->GetModeId();
+	InputRecording->Tuning = FG::GetTuning(*MoverComponent);
+}
+
+bool AFGPawn::StopInputRecording(const FString& Path)
+{
+	if(!InputRecording)
+	{
+		return false;
+	}
+
+	const bool bSaved = InputRecording->SaveToFile(Path);
+	InputRecording.Reset();
+	return bSaved;
+}
+
+bool AFGPawn::StartInputReplay(const FString& Path)
+{
+	TUniquePtr<FFGInputReplay> Replay = MakeUnique<FFGInputReplay>();
+	if(!Replay->Recording.LoadFromFile(Path))
+	{
+		return false;
+	}
+
+	const FFGInputRecording& Recording = Replay->Recording;
+	if(Recording.StartMode == EFGModeId::None)
+	{
+		UE_LOGFMT(LogMover, Error, "FG.Input.Replay - {Pawn}: {Path} doesn't say which mode it starts in, can't replay it", GetName(), Path);
+		return false;
+	}
+
+	// The start state goes in through the simulation, anywhere else would be corrected away by the authority.
+	if(!HasAuthority())
+	{
+		UE_LOGFMT(LogMover, Error, "FG.Input.Replay - {Pawn}: replays have to start on the server or standalone", GetName());
+		return false;
+	}
+
+	// Location, rotation, velocity and mode all land in the sync state of the first replayed tick.
+	TSharedPtr<FFGInstantEffect_RestoreState> RestoreState = MakeShared<FFGInstantEffect_RestoreState>();
+	RestoreState->Location = Recording.StartLocation;
+	RestoreState->Rotation = Recording.StartRotation;
+	RestoreState->Velocity = Recording.StartVelocity;
+	RestoreState->ModeId = Recording.StartMode;
+	MoverComponent->QueueInstantMovementEffect(RestoreState);
+
+	// The recorded tuning already has the recording's CVar overrides in, ours mustn't go on top.
+	if(InputReplay)
+	{
+		Replay->PreviousTuning = InputReplay->PreviousTuning;
+		Replay->bPreviousTuningOverrides = InputReplay->bPreviousTuningOverrides;
+	}
+	else
+	{
+		Replay->PreviousTuning = MoverComponent->GetTuning();
+		Replay->bPreviousTuningOverrides = MoverComponent->AppliesTuningOverrides();
+	}
+
+	MoverComponent->SetTuning(Recording.Tuning, false);
+	MoverComponent->WakeFromRest();
+
+	UE_LOGFMT(LogMover, Log, "FG.Input.Replay - {Pawn}: replaying {Num} cmds from {Path}", GetName(), Recording.Samples.Num(), Path);
+	InputReplay = MoveTemp(Replay);
+	return true;
+}
+
+void AFGPawn::StopInputReplay()
+{
+	if(!InputReplay)
+	{
+		return;
+	}
+
+	InputReplay->Report(this);
+	MoverComponent->SetTuning(InputReplay->PreviousTuning, InputReplay->bPreviousTuningOverrides);
+	InputReplay.Reset();
+}
+
 // Produce input is used to build an input cmd for the frame.
 void AFGPawn::ProduceInput_Implementation(int32 SimTimeMs, FMoverInputCmdContext& OutInputCmd)
 {
 	FFGMoverInputCmd& CharacterInputs = OutInputCmd.InputCollection.FindOrAddMutableDataByType<FFGMoverInputCmd>();
 
-	if (!GetController())
+	// A replay drives the pawn by itself, with or without a controller.
+	if (InputReplay)
+	{
+		InputReplay->Next(SimTimeMs, GetActorLocation(), CharacterInputs, this);
+		if (InputReplay->IsFinished())
+		{
+			StopInputReplay();
+		}
+		return;
+	}
+
+	if (InputProducer)
+	{
+		InputProducer->ProduceInput(*this, SimTimeMs, CharacterInputs);
+	}
+	else if (!GetController())
 	{
 		if (GetLocalRole() == ENetRole::ROLE_Authority && GetRemoteRole() == ENetRole::ROLE_SimulatedProxy)
 		{
@@ -104,19 +217,26 @@ void AFGPawn::ProduceInput_Implementation(int32 SimTimeMs, FMoverInputCmdContext
 		}
 		return;
 	}
+	else
+	{
+		FRotator IntentRotation = GetControlRotation();
+		IntentRotation.Pitch = 0.0f;
+		IntentRotation.Roll = 0.0f;
+
+		CharacterInputs.ControlRotation = GetControlRotation();
+		CharacterInputs.bUsingMovementBase = false;
+		CharacterInputs.OrientationIntent = IntentRotation.Vector();
+		CharacterInputs.bIsJumpPressed = JumpButtonDown;
+		CharacterInputs.bIsCrouchPressed = CrouchButtonDown;
+		CharacterInputs.bIsSprintPressed = SprintButtonDown;
+		CharacterInputs.SetMoveInput(EMoveInputType::DirectionalIntent, CachedMoveInputIntent);
+	}
 
-	FRotator IntentRotation = GetControlRotation();
-	IntentRotation.Pitch = 0.0f;
-	IntentRotation.Roll = 0.0f;
-
-	UE_LOGFMT(LogMover, Display, "Local - JumpButtonDown {Jumping}", JumpButtonDown);
-
-	UE_LOGFMT(LogMover, Display, "Input - {Vector}", CachedMoveInputIntent.ToString());
+	// Predict with exactly what the server is going to deserialize.
+	CharacterInputs.Quantize();
 
-	CharacterInputs.ControlRotation = GetControlRotation();
-	CharacterInputs.bUsingMovementBase = false;
-	CharacterInputs.OrientationIntent = IntentRotation.Vector();
-	CharacterInputs.bIsJumpPressed = JumpButtonDown;
-	CharacterInputs.bIsCrouchPressed = CrouchButtonDown;
-	CharacterInputs.SetMoveInput(EMoveInputType::DirectionalIntent, CachedMoveInputIntent);
+	if (InputRecording)
+	{
+		InputRecording->Record(SimTimeMs, GetActorLocation(), MoverComponent->GetModeId(), CharacterInputs);
+	}
 }
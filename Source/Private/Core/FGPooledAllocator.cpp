@@ -0,0 +1,60 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGPooledAllocator.h"
+#include "FGMovementTrace.h"
+
+LLM_DEFINE_TAG(FGMovement_Tick);
+
+namespace FG::Memory
+{
+	FPool::FPool(SIZE_T InBlockSize, uint32 InAlignment)
+		: BlockSize(InBlockSize)
+		, Alignment(FMath::Max<uint32>(InAlignment, alignof(void*)))
+	{}
+
+	FPool::~FPool()
+	{
+		while(void* Block = FreeList.Pop())
+		{
+			FMemory::Free(Block);
+		}
+	}
+
+	void* FPool::Allocate(SIZE_T Size)
+	{
+		if(Size == BlockSize)
+		{
+			if(void* Block = FreeList.Pop())
+			{
+				return Block;
+			}
+		}
+
+		FG::Trace::Count(FG::Trace::FrameCounters.HeapAllocations);
+		return FMemory::Malloc(Size, Alignment);
+	}
+
+	void FPool::Free(void* Ptr, SIZE_T Size)
+	{
+		if(!Ptr)
+		{
+			return;
+		}
+
+		if(Size == BlockSize)
+		{
+			FreeList.Push(Ptr);
+		}
+		else
+		{
+			FMemory::Free(Ptr);
+		}
+	}
+}
@@ -0,0 +1,58 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGRestState.h"
+#include "Core/FGDataModel.h"
+#include "FGMovementCVars.h"
+#include "Components/PrimitiveComponent.h"
+#include "MoveLibrary/FloorQueryUtils.h"
+#include "MoverSimulationTypes.h"
+
+bool FFGRestState::IsResting(const FFGMoverSyncState& SyncState) const
+{
+	return SyncState.bResting && !bWakeRequested;
+}
+
+void FFGRestState::Update(bool bIdle, const FFloorCheckResult& Floor, uint8 StartIdleTicks, FFGMoverSyncState& OutSyncState)
+{
+	// A full tick ran, whatever asked for it has been seen to.
+	bWakeRequested = false;
+
+	OutSyncState.IdleTicks = 0;
+	OutSyncState.bResting = false;
+
+	const UPrimitiveComponent* Primitive = Floor.HitResult.GetComponent();
+	if(!FG::CVars::RestEnabled || !bIdle || !Floor.bWalkableFloor || !Primitive)
+	{
+		return;
+	}
+
+	const int32 NumIdleTicks = StartIdleTicks + 1;
+	if(NumIdleTicks >= FG::CVars::RestTicks)
+	{
+		OutSyncState.bResting	= true;
+		FloorPrimitive			= Primitive;
+		FloorTransform			= Primitive->GetComponentTransform();
+	}
+	else
+	{
+		OutSyncState.IdleTicks = static_cast<uint8>(FMath::Min(NumIdleTicks, int32(MAX_uint8)));
+	}
+}
+
+bool FFGRestState::CanStayAtRest(const FFGMoverInputCmd& Input, const FProposedMove& ProposedMove) const
+{
+	if(!FG::CVars::RestEnabled || bWakeRequested || Input.HasMoveIntent() || !ProposedMove.LinearVelocity.IsNearlyZero() || !ProposedMove.AngularVelocity.IsZero())
+	{
+		return false;
+	}
+
+	const UPrimitiveComponent* Primitive = FloorPrimitive.Get();
+	return Primitive && Primitive->GetComponentTransform().Equals(FloorTransform);
+}
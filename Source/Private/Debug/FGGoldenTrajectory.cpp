@@ -0,0 +1,168 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGMoverComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Logging/StructuredLog.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectIterator.h"
+
+/**
+ * Golden trajectory tooling. Run a scripted session, save the per mover trajectory hashes
+ * and cost totals, then check later runs against them:
+ *
+ *		FG.Golden.Reset
+ *		... play the scripted inputs ...
+ *		FG.Golden.Save [File]	- or -	FG.Golden.Check [File]
+ *
+ * Each line of a golden file is "<Owner> <Ticks> <Hash> <AvgTickUs> <AvgSweeps>".
+ * Check fails a mover when the tick count or hash differ, or when its average cost went
+ * past the golden one by more than FG.Golden.CostTolerance.
+ */
+namespace FG::Golden
+{
+	static float CostTolerance = 0.25f;
+	static FAutoConsoleVariableRef CVarCostTolerance(
+		TEXT("FG.Golden.CostTolerance"),
+		CostTolerance,
+		TEXT("Fraction an FG.Golden.Check run may exceed the golden average tick cost by (0.25 = 25%)."),
+		ECVF_Default
+	);
+
+	static FString GetGoldenPath(const TArray<FString>& Args)
+	{
+		if(Args.Num() > 0)
+		{
+			return Args[0];
+		}
+		return FPaths::ProjectSavedDir() / TEXT("FGMovement") / TEXT("Golden.txt");
+	}
+
+	static TArray<UFGMoverComponent*> GatherMovers()
+	{
+		TArray<UFGMoverComponent*> Movers;
+		for(TObjectIterator<UFGMoverComponent> It; It; ++It)
+		{
+			if(!It->IsTemplate() && It->GetOwner() && It->GetWorld() && It->GetWorld()->IsGameWorld())
+			{
+				Movers.Add(*It);
+			}
+		}
+
+		// Owner names are the only stable key between runs, keep the file sorted by them.
+		Movers.Sort([](const UFGMoverComponent& A, const UFGMoverComponent& B)
+		{
+			return A.GetOwner()->GetName() < B.GetOwner()->GetName();
+		});
+		return Movers;
+	}
+
+	static FAutoConsoleCommand CmdReset(
+		TEXT("FG.Golden.Reset"),
+		TEXT("Resets the trajectory hash and cost totals of every FG mover."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			for(UFGMoverComponent* Mover : GatherMovers())
+			{
+				Mover->GetCostStats().Reset();
+			}
+		}));
+
+	static FAutoConsoleCommand CmdSave(
+		TEXT("FG.Golden.Save"),
+		TEXT("Writes the trajectory hash and cost totals of every FG mover to a golden file."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			TArray<FString> Lines;
+			for(const UFGMoverComponent* Mover : GatherMovers())
+			{
+				const FFGMoverCostStats& Stats = Mover->GetCostStats();
+				Lines.Add(FString::Printf(TEXT("%s %llu %08x %.3f %.3f"),
+					*Mover->GetOwner()->GetName(),
+					Stats.NumTicks,
+					Stats.TrajectoryHash,
+					Stats.GetAverageTickUs(),
+					Stats.GetAverageSweeps()));
+			}
+
+			const FString Path = GetGoldenPath(Args);
+			FFileHelper::SaveStringArrayToFile(Lines, *Path);
+			UE_LOGFMT(LogMover, Log, "FG.Golden.Save - Wrote {Num} movers to {Path}", Lines.Num(), Path);
+		}));
+
+	static FAutoConsoleCommand CmdCheck(
+		TEXT("FG.Golden.Check"),
+		TEXT("Compares the trajectory hash and cost totals of every FG mover against a golden file."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Path = GetGoldenPath(Args);
+
+			TArray<FString> Lines;
+			if(!FFileHelper::LoadFileToStringArray(Lines, *Path))
+			{
+				UE_LOGFMT(LogMover, Error, "FG.Golden.Check - Couldn't load {Path}", Path);
+				return;
+			}
+
+			TMap<FString, const UFGMoverComponent*> MoversByName;
+			for(const UFGMoverComponent* Mover : GatherMovers())
+			{
+				MoversByName.Add(Mover->GetOwner()->GetName(), Mover);
+			}
+
+			int32 NumFailed = 0;
+
+			for(const FString& Line : Lines)
+			{
+				TArray<FString> Fields;
+				if(Line.ParseIntoArrayWS(Fields) < 5)
+				{
+					continue;
+				}
+
+				const UFGMoverComponent* const* Mover = MoversByName.Find(Fields[0]);
+				if(!Mover)
+				{
+					UE_LOGFMT(LogMover, Error, "FG.Golden.Check - {Owner} missing", Fields[0]);
+					++NumFailed;
+					continue;
+				}
+
+				const FFGMoverCostStats& Stats = (*Mover)->GetCostStats();
+				const uint64 GoldenTicks = FCString::Strtoui64(*Fields[1], nullptr, 10);
+				const uint32 GoldenHash = FParse::HexNumber(*Fields[2]);
+				const double GoldenTickUs = FCString::Atod(*Fields[3]);
+
+				if(Stats.NumTicks != GoldenTicks || Stats.TrajectoryHash != GoldenHash)
+				{
+					UE_LOGFMT(LogMover, Error, "FG.Golden.Check - {Owner} diverged ({Ticks} ticks, hash {Hash}) from golden ({GoldenTicks} ticks, hash {GoldenHash})",
+						Fields[0], Stats.NumTicks, FString::Printf(TEXT("%08x"), Stats.TrajectoryHash), GoldenTicks, Fields[2]);
+					++NumFailed;
+				}
+				else if(Stats.GetAverageTickUs() > GoldenTickUs * (1.0 + CostTolerance))
+				{
+					UE_LOGFMT(LogMover, Error, "FG.Golden.Check - {Owner} went over budget, {TickUs}us per tick vs golden {GoldenTickUs}us",
+						Fields[0], Stats.GetAverageTickUs(), GoldenTickUs);
+					++NumFailed;
+				}
+			}
+
+			if(NumFailed > 0)
+			{
+				UE_LOGFMT(LogMover, Error, "FG.Golden.Check - FAILED, {Num} movers don't match {Path}", NumFailed, Path);
+			}
+			else
+			{
+				UE_LOGFMT(LogMover, Log, "FG.Golden.Check - Passed against {Path}", Path);
+			}
+		}));
+}
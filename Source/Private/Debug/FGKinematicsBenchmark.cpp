@@ -0,0 +1,121 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGKinematics.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Logging/StructuredLog.h"
+#include "MoverLog.h"
+
+/**
+ * Microbenchmark for the FG kinematics kernel. Doesn't need a world, so it can be run
+ * from any target (including a headless Linux server) with:
+ *
+ *		-ExecCmds="FG.Bench.Kinematics 10000000"
+ */
+namespace FG::Bench
+{
+	struct FKinematicsResult
+	{
+		double NsPerStep	= 0.0;
+		FVector Checksum	= FVector::ZeroVector; // Keeps the optimizer from throwing the loop away.
+	};
+
+	// What a mode specialized on its surface runs.
+	template<EFGMoveSurface Surface>
+	FORCEINLINE void StepSpecialized(FVector& Velocity, const FFGMovementTuning& Tuning, float DeltaTime, const FVector& Intent)
+	{
+		const float DesiredSpeed = static_cast<float>(FG::Kinematics::TSurfaceConstants<Surface>::IntentSpeed(Tuning));
+
+		FG::Kinematics::ApplyDamping<Surface>(Velocity, Tuning, DeltaTime);
+		FG::Kinematics::ApplyAcceleration<Surface>(Velocity, Tuning, DeltaTime, Intent, DesiredSpeed);
+	}
+
+	/**
+	 * @param bSpecialized - Use the compile time surface kernels the modes run, rather than the runtime switch.
+	 */
+	template<bool bSpecialized>
+	static FKinematicsResult RunKinematics(int32 NumSteps)
+	{
+		constexpr float DeltaTime = 1.0f / 60.0f;
+		constexpr int32 NumIntents = 8;
+
+		const FFGMovementTuning Tuning;
+
+		// Walk around a circle of intents, so every step does real work.
+		FVector Intents[NumIntents];
+		for(int32 Idx = 0; Idx < NumIntents; ++Idx)
+		{
+			const double Angle = (2.0 * UE_DOUBLE_PI * Idx) / NumIntents;
+			Intents[Idx] = FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0);
+		}
+
+		FVector Velocity = FVector::ZeroVector;
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		for(int32 Step = 0; Step < NumSteps; ++Step)
+		{
+			const FVector& Intent = Intents[(Step >> 4) % NumIntents];
+
+			if constexpr (bSpecialized)
+			{
+				if(Step & 64)
+				{
+					StepSpecialized<EFGMoveSurface::Air>(Velocity, Tuning, DeltaTime, Intent);
+				}
+				else
+				{
+					StepSpecialized<EFGMoveSurface::Ground>(Velocity, Tuning, DeltaTime, Intent);
+				}
+			}
+			else
+			{
+				const EFGMoveSurface Surface = (Step & 64) ? EFGMoveSurface::Air : EFGMoveSurface::Ground;
+				const float DesiredSpeed = Surface == EFGMoveSurface::Ground ? Tuning.GroundSpeed : Tuning.AirSpeed;
+
+				FG::Kinematics::ApplyDamping(Velocity, Tuning, Surface, DeltaTime);
+				FG::Kinematics::ApplyAcceleration(Velocity, Tuning, Surface, DeltaTime, Intent, DesiredSpeed);
+			}
+		}
+
+		const double EndTime = FPlatformTime::Seconds();
+
+		FKinematicsResult Result;
+		Result.NsPerStep = ((EndTime - StartTime) * 1e9) / FMath::Max(NumSteps, 1);
+		Result.Checksum = Velocity;
+		return Result;
+	}
+
+	static FAutoConsoleCommand CmdBenchKinematics(
+		TEXT("FG.Bench.Kinematics"),
+		TEXT("Runs the FG damping/acceleration kernel for N steps (default 10000000) and reports ns/step, for both the runtime and the compile time surface selection."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			int32 NumSteps = 10000000;
+			if(Args.Num() > 0)
+			{
+				LexFromString(NumSteps, *Args[0]);
+			}
+			NumSteps = FMath::Max(NumSteps, 1);
+
+			RunKinematics<false>(FMath::Min(NumSteps, 10000)); // Warm up.
+			RunKinematics<true>(FMath::Min(NumSteps, 10000));
+
+			const FKinematicsResult Runtime = RunKinematics<false>(NumSteps);
+			const FKinematicsResult Specialized = RunKinematics<true>(NumSteps);
+
+			UE_LOGFMT(LogMover, Log, "FG.Bench.Kinematics - {Steps} steps, runtime surface {RuntimeNs} ns/step, specialized {SpecializedNs} ns/step (checksums {RuntimeChecksum} / {SpecializedChecksum})",
+				NumSteps,
+				Runtime.NsPerStep,
+				Specialized.NsPerStep,
+				*Runtime.Checksum.ToString(),
+				*Specialized.Checksum.ToString());
+		}));
+}
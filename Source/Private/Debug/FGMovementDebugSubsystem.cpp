@@ -0,0 +1,202 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Debug/FGMovementDebugSubsystem.h"
+#include "Core/FGMoverComponent.h"
+#include "Components/LineBatchComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "FGMovementCVars.h"
+#include "HAL/IConsoleManager.h"
+#include "Logging/StructuredLog.h"
+#include "MoverLog.h"
+#include "UObject/UObjectIterator.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FGMovementDebugSubsystem)
+
+namespace FG::Debug
+{
+	static constexpr float NormalLength		= 30.0f;
+	static constexpr float VelocitySeconds	= 0.1f;	// Velocity vectors show how far the mover gets in this long.
+	static constexpr float LineThickness	= 1.0f;
+
+	static FColor GetModeColor(EFGModeId Mode)
+	{
+		switch(Mode)
+		{
+		case EFGModeId::Walk:	return FColor::Green;
+		case EFGModeId::Air:	return FColor::Yellow;
+		case EFGModeId::Surf:	return FColor::Cyan;
+		default:				return FColor::White;
+		}
+	}
+}
+
+void UFGMovementDebugSubsystem::FTrack::Record(UFGMoverComponent& InMover)
+{
+	FFGDebugSample& Sample = Samples[Head];
+
+	Sample.Location	= InMover.GetFeetLocation();
+	Sample.Velocity	= InMover.GetVelocity();
+	Sample.Mode		= InMover.GetModeId();
+
+	// The floor the last tick found, no need to go through the blackboard.
+	const FFloorCheckResult* Floor = InMover.GetFloorCache().GetLastFloor();
+	Sample.FloorNormal		= Floor && Floor->bBlockingHit ? Floor->HitResult.ImpactNormal : FVector::ZeroVector;
+	Sample.bWalkableFloor	= Floor && Floor->bWalkableFloor;
+
+	Head = (Head + 1) % Capacity;
+	Num = FMath::Min(Num + 1, Capacity);
+}
+
+void UFGMovementDebugSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+#if ENABLE_DRAW_DEBUG
+	Tracks.RemoveAllSwap([](const FTrack& Track) { return !Track.Mover.IsValid(); });
+
+	ULineBatchComponent* LineBatcher = GetWorld()->LineBatcher;
+	if(!LineBatcher)
+	{
+		return;
+	}
+
+	TArray<FBatchedLine> Lines;
+	for(FTrack& Track : Tracks)
+	{
+		Track.Record(*Track.Mover.Get());
+		Lines.Reserve(Lines.Num() + Track.Num * 2 + 1);
+
+		for(int32 Idx = 0; Idx < Track.Num; ++Idx)
+		{
+			const FFGDebugSample& Sample = Track.GetSample(Idx);
+
+			if(Idx > 0)
+			{
+				const FFGDebugSample& Previous = Track.GetSample(Idx - 1);
+				Lines.Emplace(Previous.Location, Sample.Location, FLinearColor(FG::Debug::GetModeColor(Sample.Mode)), 0.0f, FG::Debug::LineThickness, SDPG_World);
+			}
+
+			if(!Sample.FloorNormal.IsZero())
+			{
+				const FColor NormalColor = Sample.bWalkableFloor ? FColor::Blue : FColor::Red;
+				Lines.Emplace(Sample.Location, Sample.Location + Sample.FloorNormal * FG::Debug::NormalLength, FLinearColor(NormalColor), 0.0f, FG::Debug::LineThickness, SDPG_World);
+			}
+		}
+
+		const FFGDebugSample& Latest = Track.GetSample(Track.Num - 1);
+		Lines.Emplace(Latest.Location, Latest.Location + Latest.Velocity * FG::Debug::VelocitySeconds, FLinearColor(FColor::White), 0.0f, FG::Debug::LineThickness, SDPG_World);
+	}
+
+	// One pass for every mover, rather than a DrawDebugLine call per line.
+	LineBatcher->DrawLines(Lines);
+#endif
+}
+
+bool UFGMovementDebugSubsystem::IsTickable() const
+{
+	return FG::CVars::DrawMovementDebug && !Tracks.IsEmpty() && Super::IsTickable();
+}
+
+TStatId UFGMovementDebugSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFGMovementDebugSubsystem, STATGROUP_Tickables);
+}
+
+bool UFGMovementDebugSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if ENABLE_DRAW_DEBUG
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+#else
+	return false;
+#endif
+}
+
+bool UFGMovementDebugSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFGMovementDebugSubsystem::SetDrawEnabled(UFGMoverComponent* Mover, bool bEnabled)
+{
+	const int32 Idx = Tracks.IndexOfByPredicate([Mover](const FTrack& Track) { return Track.Mover.Get() == Mover; });
+
+	if(bEnabled && Mover && Idx == INDEX_NONE)
+	{
+		Tracks.AddDefaulted_GetRef().Mover = Mover;
+	}
+	else if(!bEnabled && Idx != INDEX_NONE)
+	{
+		Tracks.RemoveAtSwap(Idx);
+	}
+}
+
+bool UFGMovementDebugSubsystem::IsDrawEnabled(const UFGMoverComponent* Mover) const
+{
+	return Tracks.ContainsByPredicate([Mover](const FTrack& Track) { return Track.Mover.Get() == Mover; });
+}
+
+namespace FG::Debug
+{
+	static FAutoConsoleCommand CmdDraw(
+		TEXT("FG.Debug.Draw"),
+		TEXT("Toggles movement debug drawing of one pawn (by name), or turns it on for all or off for none. Needs FG.DrawMovementDebug. Usage: FG.Debug.Draw [PawnName|all|none]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Filter = Args.Num() > 0 ? Args[0] : TEXT("all");
+			int32 NumDrawn = 0;
+
+			for(const FWorldContext& Context : GEngine->GetWorldContexts())
+			{
+				UWorld* World = Context.World();
+				UFGMovementDebugSubsystem* Subsystem = World ? World->GetSubsystem<UFGMovementDebugSubsystem>() : nullptr;
+				if(!Subsystem)
+				{
+					continue;
+				}
+
+				if(Filter == TEXT("none"))
+				{
+					Subsystem->ClearDrawn();
+					continue;
+				}
+
+				for(TObjectIterator<UFGMoverComponent> It; It; ++It)
+				{
+					UFGMoverComponent* Mover = *It;
+					if(Mover->GetWorld() != World || !Mover->GetOwner())
+					{
+						continue;
+					}
+
+					if(Filter == TEXT("all"))
+					{
+						Subsystem->SetDrawEnabled(Mover, true);
+					}
+					else if(Mover->GetOwner()->GetName() == Filter)
+					{
+						Subsystem->SetDrawEnabled(Mover, !Subsystem->IsDrawEnabled(Mover));
+					}
+					else
+					{
+						continue;
+					}
+
+					NumDrawn += Subsystem->IsDrawEnabled(Mover) ? 1 : 0;
+				}
+			}
+
+			UE_LOGFMT(LogMover, Log, "FG.Debug.Draw - Drawing {Num} movers", NumDrawn);
+			if(!FG::CVars::DrawMovementDebug && NumDrawn > 0)
+			{
+				UE_LOGFMT(LogMover, Log, "FG.Debug.Draw - Set FG.DrawMovementDebug 1 to see them");
+			}
+		}));
+}
@@ -0,0 +1,277 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGInputProducer.h"
+#include "Core/FGMovementSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "FGMovementCVars.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/IConsoleManager.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/App.h"
+#include "Misc/Parse.h"
+#include "MoverLog.h"
+
+/**
+ * Whole-frame benchmark for UFGMovementSubsystem's floor batch. For 100, 500 and 1000 synthetic
+ * FG pawns (see FG::SyntheticInput) runs a number of game frames with FG.Parallel.FloorBatch off,
+ * then on split over 1, 2, 4... up to every worker thread, and reports the average and p95 busy
+ * time of the whole game frame - delta time minus the time spent idling for the frame rate cap -
+ * and the speedup over the batch being off. Meant to be run uncapped on a dedicated server:
+ *
+ *		<Project> MovementExample -server -nullrhi -log -ExecCmds="t.MaxFPS 0, FG.Bench.Parallel"
+ *
+ *		FG.Bench.Parallel [Frames=300] [Warmup=30] [Movement=Mixed] [Seed=0] [Spacing=300]
+ */
+namespace FG::ParallelBench
+{
+	static const int32 PawnCounts[] = { 100, 500, 1000 };
+
+	struct FConfig
+	{
+		bool	bFloorBatch	= false;
+		int32	NumTasks	= 1;
+	};
+
+	struct FState
+	{
+		enum class EPhase : uint8
+		{
+			Spawn,
+			Warmup,
+			Measure,
+		};
+
+		TWeakObjectPtr<UWorld>	World;
+		TArray<FConfig>			Configs;
+		TArray<double>			FrameMs;
+		EFGSyntheticMovement	Movement		= EFGSyntheticMovement::Mixed;
+		int32					Seed			= 0;
+		float					Spacing			= 300.0f;
+		int32					Frames			= 300;
+		int32					WarmupFrames	= 30;
+
+		EPhase					Phase			= EPhase::Spawn;
+		int32					CountIdx		= 0;
+		int32					ConfigIdx		= 0;
+		int32					PhaseFrames		= 0;
+		double					OffAvgMs		= 0.0;	// Of the current pawn count, what the speedup is against.
+
+		// The CVars the benchmark flips, put back when it's done.
+		bool					SavedFloorBatch	= true;
+		int32					SavedTasks		= 0;
+	};
+
+	static FTSTicker::FDelegateHandle TickerHandle;
+
+	static void ApplyConfig(const FConfig& Config)
+	{
+		FG::CVars::ParallelFloorBatch = Config.bFloorBatch;
+		FG::CVars::ParallelTasks = Config.NumTasks;
+	}
+
+	static double Percentile(const TArray<double>& Sorted, double Fraction)
+	{
+		if(Sorted.IsEmpty())
+		{
+			return 0.0;
+		}
+
+		// Nearest rank.
+		const int32 Rank = FMath::CeilToInt(Fraction * Sorted.Num());
+		return Sorted[FMath::Clamp(Rank - 1, 0, Sorted.Num() - 1)];
+	}
+
+	static void Finish(FState& State, UWorld* World)
+	{
+		if(World)
+		{
+			FG::SyntheticInput::DestroyPawns(*World);
+		}
+
+		FG::CVars::ParallelFloorBatch = State.SavedFloorBatch;
+		FG::CVars::ParallelTasks = State.SavedTasks;
+	}
+
+	static void FinishConfig(FState& State)
+	{
+		const FConfig& Config = State.Configs[State.ConfigIdx];
+
+		double TotalMs = 0.0;
+		for(const double Ms : State.FrameMs)
+		{
+			TotalMs += Ms;
+		}
+		const double AvgMs = State.FrameMs.IsEmpty() ? 0.0 : TotalMs / State.FrameMs.Num();
+
+		State.FrameMs.Sort();
+		const double P95Ms = Percentile(State.FrameMs, 0.95);
+
+		if(!Config.bFloorBatch)
+		{
+			State.OffAvgMs = AvgMs;
+			UE_LOGFMT(LogMover, Log, "FG.Bench.Parallel - {Pawns} pawns, batch off: avg {Avg} ms, p95 {P95} ms per frame",
+				PawnCounts[State.CountIdx], AvgMs, P95Ms);
+		}
+		else
+		{
+			UE_LOGFMT(LogMover, Log, "FG.Bench.Parallel - {Pawns} pawns, batch on, {Tasks} tasks: avg {Avg} ms, p95 {P95} ms per frame, {Speedup}x",
+				PawnCounts[State.CountIdx], Config.NumTasks, AvgMs, P95Ms, AvgMs > 0.0 ? State.OffAvgMs / AvgMs : 0.0);
+		}
+
+		State.FrameMs.Reset();
+	}
+
+	/** Advance the benchmark by a game frame. @return Whether it's still running. */
+	static bool Step(FState& State)
+	{
+		UWorld* World = State.World.Get();
+		if(!World)
+		{
+			UE_LOGFMT(LogMover, Warning, "FG.Bench.Parallel - World went away, stopping");
+			Finish(State, nullptr);
+			return false;
+		}
+
+		switch(State.Phase)
+		{
+		case FState::EPhase::Spawn:
+		{
+			if(State.CountIdx >= UE_ARRAY_COUNT(PawnCounts))
+			{
+				Finish(State, World);
+				return false;
+			}
+
+			TActorIterator<APlayerStart> Start(World);
+			const FVector Origin = Start ? Start->GetActorLocation() : FVector(0.0, 0.0, 100.0);
+			const int32 NumPawns = FG::SyntheticInput::SpawnPawns(*World, Origin, PawnCounts[State.CountIdx], State.Movement, State.Seed, State.Spacing).Num();
+
+			UE_LOGFMT(LogMover, Log, "FG.Bench.Parallel - Spawned {Num}/{Count} pawns", NumPawns, PawnCounts[State.CountIdx]);
+
+			State.ConfigIdx = 0;
+			ApplyConfig(State.Configs[State.ConfigIdx]);
+			State.Phase = FState::EPhase::Warmup;
+			State.PhaseFrames = 0;
+			return true;
+		}
+
+		case FState::EPhase::Warmup:
+		{
+			// Also lets the frame that switched the config go by, it measures neither.
+			if(++State.PhaseFrames >= State.WarmupFrames)
+			{
+				State.Phase = FState::EPhase::Measure;
+			}
+			return true;
+		}
+
+		case FState::EPhase::Measure:
+		{
+			// The whole frame, not only the FG parts of it, so the batch pays for what it costs elsewhere.
+			State.FrameMs.Add(FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0) * 1000.0);
+			if(State.FrameMs.Num() < State.Frames)
+			{
+				return true;
+			}
+
+			FinishConfig(State);
+
+			if(++State.ConfigIdx < State.Configs.Num())
+			{
+				ApplyConfig(State.Configs[State.ConfigIdx]);
+				State.Phase = FState::EPhase::Warmup;
+				State.PhaseFrames = 0;
+				return true;
+			}
+
+			FG::SyntheticInput::DestroyPawns(*World);
+			GEngine->ForceGarbageCollection(true);
+
+			++State.CountIdx;
+			State.Phase = FState::EPhase::Spawn;
+			return true;
+		}
+		}
+
+		return false;
+	}
+
+	static FAutoConsoleCommand CmdBenchParallel(
+		TEXT("FG.Bench.Parallel"),
+		TEXT("Spawns 100/500/1000 synthetic FG pawns in turn and reports whole-frame ms avg/p95 with FG.Parallel.FloorBatch off, then on across 1..N tasks. ")
+		TEXT("Usage: FG.Bench.Parallel [Frames=300] [Warmup=30] [Movement=Mixed] [Seed=0] [Spacing=300]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if(TickerHandle.IsValid())
+			{
+				UE_LOGFMT(LogMover, Warning, "FG.Bench.Parallel - Already running");
+				return;
+			}
+
+			UWorld* World = FG::SyntheticInput::FindAuthorityWorld();
+			if(!World)
+			{
+				UE_LOGFMT(LogMover, Warning, "FG.Bench.Parallel - No server or standalone game world");
+				return;
+			}
+
+			TSharedRef<FState> State = MakeShared<FState>();
+			State->World = World;
+			State->SavedFloorBatch = FG::CVars::ParallelFloorBatch;
+			State->SavedTasks = FG::CVars::ParallelTasks;
+
+			const FString Params = FString::Join(Args, TEXT(" "));
+			FParse::Value(*Params, TEXT("Frames="), State->Frames);
+			FParse::Value(*Params, TEXT("Warmup="), State->WarmupFrames);
+			FParse::Value(*Params, TEXT("Seed="), State->Seed);
+			FParse::Value(*Params, TEXT("Spacing="), State->Spacing);
+
+			State->Frames = FMath::Max(State->Frames, 1);
+			State->WarmupFrames = FMath::Max(State->WarmupFrames, 1);
+
+			FString MovementName;
+			if(FParse::Value(*Params, TEXT("Movement="), MovementName))
+			{
+				const int64 Value = StaticEnum<EFGSyntheticMovement>()->GetValueByNameString(MovementName);
+				if(Value != INDEX_NONE)
+				{
+					State->Movement = static_cast<EFGSyntheticMovement>(Value);
+				}
+			}
+
+			// Off first, it's what every other row is compared against.
+			State->Configs.Add({ false, 1 });
+
+			const int32 MaxTasks = FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+			for(int32 NumTasks = 1; NumTasks < MaxTasks; NumTasks *= 2)
+			{
+				State->Configs.Add({ true, NumTasks });
+			}
+			State->Configs.Add({ true, MaxTasks });
+
+			// Leftovers of an earlier run would skew the first count.
+			FG::SyntheticInput::DestroyPawns(*World);
+
+			UE_LOGFMT(LogMover, Log, "FG.Bench.Parallel - {Num} configurations, {Frames} frames each", State->Configs.Num(), State->Frames);
+
+			TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([State](float)
+			{
+				const bool bRunning = Step(*State);
+				if(!bRunning)
+				{
+					TickerHandle.Reset();
+				}
+				return bRunning;
+			}));
+		}));
+}
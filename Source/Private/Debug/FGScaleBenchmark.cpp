@@ -0,0 +1,494 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Core/FGInputProducer.h"
+#include "Core/FGMovementSubsystem.h"
+#include "Core/FGMoverComponent.h"
+#include "Core/FGPawn.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "MoverLog.h"
+
+/**
+ * Server scale benchmark. For each pawn count spawns that many FG pawns driven by seeded
+ * synthetic input (see UFGSyntheticInputProducer), lets them settle, then runs a fixed number
+ * of sim frames per pawn and reports the movement cost of each game frame as p50/p95/p99, along with
+ * sweeps per pawn per sim frame and the physical memory each pawn added. Results go to the log
+ * and to Saved/FGMovement/ScaleBench_<Timestamp>.csv/.json.
+ *
+ * Meant to be run headless on a dedicated server, on MovementExample or a generated arena:
+ *
+ *		<Project> MovementExample -server -nullrhi -log -ExecCmds="FG.Bench.Scale Arena=1 Quit=1"
+ *
+ *		FG.Bench.Scale [Frames=600] [Counts=100,500,1000,2000] [Movement=Mixed] [Seed=0] [Spacing=300] [Warmup=60] [Arena=0] [Quit=0]
+ *
+ * The movement cost of a frame is the whole Network Prediction tick rather than the FG modes'
+ * own cycles, so Mover's and NPP's work around them counts too. It's timed from the start of
+ * the world tick to the first tick group, which covers the network receive, NPP's reconcile and
+ * replays and every fixed sim tick of the frame, plus UFGMovementSubsystem's floor batch.
+ */
+namespace FG::ScaleBench
+{
+	static const FName ArenaTag(TEXT("FGBenchArena"));
+
+	struct FResult
+	{
+		int32	NumPawns			= 0;
+		int32	NumFrames			= 0;	// Game frames sampled.
+		uint64	NumSimTicks			= 0;
+		double	P50Ms				= 0.0;
+		double	P95Ms				= 0.0;
+		double	P99Ms				= 0.0;
+		double	MaxMs				= 0.0;
+		double	SweepsPerPawnFrame	= 0.0;
+		double	BytesPerPawn		= 0.0;
+	};
+
+	struct FState;
+
+	/** Runs first in TG_PrePhysics, right after NPP's fixed ticks, to end the frame's timing. */
+	struct FPrePhysicsMarker : public FTickFunction
+	{
+		FState* State = nullptr;
+
+		virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+		virtual FString DiagnosticMessage() override { return TEXT("FG.Bench.Scale PrePhysics marker"); }
+	};
+
+	struct FState
+	{
+		enum class EPhase : uint8
+		{
+			Spawn,
+			Warmup,
+			Measure,
+		};
+
+		TWeakObjectPtr<UWorld>			World;
+		TArray<int32>					Counts;
+		TArray<TWeakObjectPtr<AFGPawn>>	Pawns;
+		TArray<double>					FrameMs;
+		TArray<FResult>					Results;
+		EFGSyntheticMovement			Movement		= EFGSyntheticMovement::Mixed;
+		int32							Seed			= 0;
+		float							Spacing			= 300.0f;
+		int32							SimFrames		= 600;
+		int32							WarmupFrames	= 60;
+		bool							bQuit			= false;
+
+		EPhase							Phase			= EPhase::Spawn;
+		int32							CountIdx		= 0;
+		int32							PhaseFrames		= 0;
+		uint64							BaseMemory		= 0;
+		double							BytesPerPawn	= 0.0;
+		uint64							BaseSimTicks	= 0;
+		uint64							BaseSweeps		= 0;
+		uint64							LastPrefetchCycles	= 0;
+
+		// Time from the start of the world tick to its first tick group, see FPrePhysicsMarker.
+		FPrePhysicsMarker				PrePhysicsMarker;
+		FDelegateHandle					TickStartHandle;
+		uint64							TickStartCycles		= 0;
+		uint64							PreActorTickCycles	= 0;
+	};
+
+	void FPrePhysicsMarker::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+	{
+		if(State && State->TickStartCycles != 0)
+		{
+			State->PreActorTickCycles += FPlatformTime::Cycles64() - State->TickStartCycles;
+			State->TickStartCycles = 0;
+		}
+	}
+
+	static void StartTiming(FState& State, UWorld& World)
+	{
+		State.TickStartHandle = FWorldDelegates::OnWorldTickStart.AddLambda([&State](UWorld* TickingWorld, ELevelTick, float)
+		{
+			if(TickingWorld == State.World.Get())
+			{
+				State.TickStartCycles = FPlatformTime::Cycles64();
+			}
+		});
+
+		State.PrePhysicsMarker.State = &State;
+		State.PrePhysicsMarker.bCanEverTick = true;
+		State.PrePhysicsMarker.bHighPriority = true;
+		State.PrePhysicsMarker.TickGroup = TG_PrePhysics;
+		State.PrePhysicsMarker.RegisterTickFunction(World.PersistentLevel);
+	}
+
+	static void StopTiming(FState& State)
+	{
+		FWorldDelegates::OnWorldTickStart.Remove(State.TickStartHandle);
+
+		// A level that went away already unregistered it.
+		if(State.World.IsValid())
+		{
+			State.PrePhysicsMarker.UnRegisterTickFunction();
+		}
+	}
+
+	static FTSTicker::FDelegateHandle TickerHandle;
+
+	static FVector FindOrigin(UWorld& World)
+	{
+		TActorIterator<APlayerStart> It(&World);
+		return It ? It->GetActorLocation() : FVector(0.0, 0.0, 100.0);
+	}
+
+	static void SpawnBlock(UWorld& World, UStaticMesh* Cube, const FVector& Location, const FRotator& Rotation, const FVector& Scale)
+	{
+		// Deferred so the mesh is set before the (static) component registers.
+		AStaticMeshActor* Block = World.SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), FTransform(Rotation, Location, Scale));
+		if(!Block)
+		{
+			return;
+		}
+
+		Block->GetStaticMeshComponent()->SetStaticMesh(Cube);
+		Block->Tags.Add(ArenaTag);
+		Block->FinishSpawning(FTransform(Rotation, Location, Scale));
+	}
+
+	/**
+	 * A flat floor with a ring of walkable ramps and surfable ramps around the origin, so every
+	 * synthetic movement has something to do whatever map is loaded. The engine cube is 100 units.
+	 */
+	static void SpawnArena(UWorld& World, const FVector& Origin, float HalfExtent)
+	{
+		UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+		if(!Cube)
+		{
+			UE_LOGFMT(LogMover, Warning, "FG.Bench.Scale - Couldn't load the engine cube, no arena");
+			return;
+		}
+
+		const double FloorScale = HalfExtent * 2.0 / 100.0;
+		SpawnBlock(World, Cube, Origin - FVector(0.0, 0.0, 150.0), FRotator::ZeroRotator, FVector(FloorScale, FloorScale, 1.0));
+
+		constexpr int32 NumRamps = 8;
+		for(int32 Idx = 0; Idx < NumRamps; ++Idx)
+		{
+			// Alternate 30 degree ramps (walkable) and 60 degree ramps (surfable).
+			const double Yaw = 360.0 * Idx / NumRamps;
+			const double Pitch = (Idx % 2) == 0 ? 30.0 : 60.0;
+			const FVector Direction = FRotator(0.0, Yaw, 0.0).Vector();
+
+			SpawnBlock(World, Cube, Origin + Direction * HalfExtent * 0.75, FRotator(Pitch, Yaw, 0.0), FVector(20.0, 10.0, 1.0));
+		}
+	}
+
+	static void DestroyArena(UWorld& World)
+	{
+		for(TActorIterator<AStaticMeshActor> It(&World); It; ++It)
+		{
+			if(It->ActorHasTag(ArenaTag))
+			{
+				It->Destroy();
+			}
+		}
+	}
+
+	/** Sum a cost counter over the live benchmark pawns. */
+	template<typename GetterType>
+	static uint64 SumPawns(const FState& State, GetterType&& Getter)
+	{
+		uint64 Sum = 0;
+		for(const TWeakObjectPtr<AFGPawn>& Pawn : State.Pawns)
+		{
+			if(const UFGMoverComponent* Mover = Pawn.IsValid() ? Pawn->FindComponentByClass<UFGMoverComponent>() : nullptr)
+			{
+				Sum += Getter(Mover->GetCostStats());
+			}
+		}
+		return Sum;
+	}
+
+	static uint64 GetPrefetchCycles(UWorld& World)
+	{
+		const UFGMovementSubsystem* Subsystem = World.GetSubsystem<UFGMovementSubsystem>();
+		return Subsystem ? Subsystem->GetTotalPrefetchCycles() : 0;
+	}
+
+	static double Percentile(const TArray<double>& Sorted, double Fraction)
+	{
+		if(Sorted.IsEmpty())
+		{
+			return 0.0;
+		}
+
+		// Nearest rank.
+		const int32 Rank = FMath::CeilToInt(Fraction * Sorted.Num());
+		return Sorted[FMath::Clamp(Rank - 1, 0, Sorted.Num() - 1)];
+	}
+
+	static void WriteResults(const FState& State)
+	{
+		const FString BasePath = FPaths::ProjectSavedDir() / TEXT("FGMovement") / FString::Printf(TEXT("ScaleBench_%s"), *FDateTime::Now().ToString());
+
+		FString Csv = TEXT("Pawns,Frames,SimTicks,P50Ms,P95Ms,P99Ms,MaxMs,SweepsPerPawnFrame,BytesPerPawn\n");
+		for(const FResult& Result : State.Results)
+		{
+			Csv += FString::Printf(TEXT("%d,%d,%llu,%.4f,%.4f,%.4f,%.4f,%.3f,%.0f\n"), Result.NumPawns, Result.NumFrames, Result.NumSimTicks,
+				Result.P50Ms, Result.P95Ms, Result.P99Ms, Result.MaxMs, Result.SweepsPerPawnFrame, Result.BytesPerPawn);
+		}
+
+		// Small and flat enough not to need the Json module.
+		const UWorld* World = State.World.Get();
+		FString Json = FString::Printf(TEXT("{\n\t\"map\": \"%s\",\n\t\"netMode\": %d,\n\t\"simFrames\": %d,\n\t\"movement\": \"%s\",\n\t\"seed\": %d,\n\t\"results\": [\n"),
+			World ? *World->GetMapName() : TEXT(""), World ? static_cast<int32>(World->GetNetMode()) : 0, State.SimFrames,
+			*StaticEnum<EFGSyntheticMovement>()->GetNameStringByValue(static_cast<int64>(State.Movement)), State.Seed);
+
+		for(int32 Idx = 0; Idx < State.Results.Num(); ++Idx)
+		{
+			const FResult& Result = State.Results[Idx];
+			Json += FString::Printf(TEXT("\t\t{ \"pawns\": %d, \"frames\": %d, \"simTicks\": %llu, \"p50Ms\": %.4f, \"p95Ms\": %.4f, \"p99Ms\": %.4f, \"maxMs\": %.4f, \"sweepsPerPawnFrame\": %.3f, \"bytesPerPawn\": %.0f }%s\n"),
+				Result.NumPawns, Result.NumFrames, Result.NumSimTicks, Result.P50Ms, Result.P95Ms, Result.P99Ms, Result.MaxMs,
+				Result.SweepsPerPawnFrame, Result.BytesPerPawn, Idx + 1 < State.Results.Num() ? TEXT(",") : TEXT(""));
+		}
+		Json += TEXT("\t]\n}\n");
+
+		const bool bWritten = FFileHelper::SaveStringToFile(Csv, *(BasePath + TEXT(".csv")))
+			&& FFileHelper::SaveStringToFile(Json, *(BasePath + TEXT(".json")));
+
+		if(bWritten)
+		{
+			UE_LOGFMT(LogMover, Log, "FG.Bench.Scale - Wrote {Path}.csv/.json", BasePath);
+		}
+		else
+		{
+			UE_LOGFMT(LogMover, Error, "FG.Bench.Scale - Couldn't write {Path}.csv/.json", BasePath);
+		}
+	}
+
+	static void FinishCount(FState& State, UWorld& World)
+	{
+		const int32 NumPawns = State.Counts[State.CountIdx];
+
+		FResult& Result = State.Results.AddDefaulted_GetRef();
+		Result.NumPawns = NumPawns;
+		Result.BytesPerPawn = State.BytesPerPawn;
+		Result.NumFrames = State.FrameMs.Num();
+		Result.NumSimTicks = SumPawns(State, [](const FFGMoverCostStats& Stats) { return Stats.NumTicks; }) - State.BaseSimTicks;
+
+		State.FrameMs.Sort();
+		Result.P50Ms = Percentile(State.FrameMs, 0.50);
+		Result.P95Ms = Percentile(State.FrameMs, 0.95);
+		Result.P99Ms = Percentile(State.FrameMs, 0.99);
+		Result.MaxMs = State.FrameMs.IsEmpty() ? 0.0 : State.FrameMs.Last();
+
+		const uint64 NumSweeps = SumPawns(State, [](const FFGMoverCostStats& Stats) { return Stats.TotalSweeps; }) - State.BaseSweeps;
+		Result.SweepsPerPawnFrame = Result.NumSimTicks > 0 ? double(NumSweeps) / Result.NumSimTicks : 0.0;
+
+		UE_LOGFMT(LogMover, Log, "FG.Bench.Scale - {Pawns} pawns over {Frames} frames: p50 {P50} ms, p95 {P95} ms, p99 {P99} ms, max {Max} ms, {Sweeps} sweeps/pawn/frame, {Bytes} bytes/pawn",
+			Result.NumPawns, Result.NumFrames, Result.P50Ms, Result.P95Ms, Result.P99Ms, Result.MaxMs, Result.SweepsPerPawnFrame, Result.BytesPerPawn);
+
+		FG::SyntheticInput::DestroyPawns(World);
+		State.Pawns.Reset();
+		State.FrameMs.Reset();
+		GEngine->ForceGarbageCollection(true);
+	}
+
+	/** Advance the benchmark by a game frame. @return Whether it's still running. */
+	static bool Step(FState& State)
+	{
+		UWorld* World = State.World.Get();
+		if(!World)
+		{
+			UE_LOGFMT(LogMover, Warning, "FG.Bench.Scale - World went away, stopping");
+			return false;
+		}
+
+		switch(State.Phase)
+		{
+		case FState::EPhase::Spawn:
+		{
+			if(State.CountIdx >= State.Counts.Num())
+			{
+				WriteResults(State);
+				DestroyArena(*World);
+
+				if(State.bQuit)
+				{
+					FPlatformMisc::RequestExit(false);
+				}
+				return false;
+			}
+
+			const int32 NumPawns = State.Counts[State.CountIdx];
+			State.BaseMemory = FPlatformMemory::GetStats().UsedPhysical;
+
+			for(AFGPawn* Pawn : FG::SyntheticInput::SpawnPawns(*World, FindOrigin(*World), NumPawns, State.Movement, State.Seed, State.Spacing))
+			{
+				State.Pawns.Add(Pawn);
+			}
+
+			UE_LOGFMT(LogMover, Log, "FG.Bench.Scale - Spawned {Num}/{Count} pawns, warming up", State.Pawns.Num(), NumPawns);
+
+			State.Phase = FState::EPhase::Warmup;
+			State.PhaseFrames = 0;
+			return true;
+		}
+
+		case FState::EPhase::Warmup:
+		{
+			if(++State.PhaseFrames < State.WarmupFrames)
+			{
+				return true;
+			}
+
+			// Memory is taken once the pawns have had a chance to fill their buffers and pools.
+			const uint64 UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+			State.BytesPerPawn = State.Pawns.Num() > 0 && UsedMemory > State.BaseMemory
+				? double(UsedMemory - State.BaseMemory) / State.Pawns.Num() : 0.0;
+
+			State.BaseSimTicks	= SumPawns(State, [](const FFGMoverCostStats& Stats) { return Stats.NumTicks; });
+			State.BaseSweeps	= SumPawns(State, [](const FFGMoverCostStats& Stats) { return Stats.TotalSweeps; });
+			State.LastPrefetchCycles	= GetPrefetchCycles(*World);
+			State.PreActorTickCycles	= 0;
+			State.Phase			= FState::EPhase::Measure;
+			State.PhaseFrames	= 0;
+			return true;
+		}
+
+		case FState::EPhase::Measure:
+		{
+			const uint64 PrefetchCycles = GetPrefetchCycles(*World);
+			State.FrameMs.Add(FPlatformTime::ToMilliseconds64(State.PreActorTickCycles + PrefetchCycles - State.LastPrefetchCycles));
+			State.LastPrefetchCycles = PrefetchCycles;
+			State.PreActorTickCycles = 0;
+
+			const uint64 NumSimTicks = SumPawns(State, [](const FFGMoverCostStats& Stats) { return Stats.NumTicks; }) - State.BaseSimTicks;
+			if(NumSimTicks < uint64(State.SimFrames) * FMath::Max(State.Pawns.Num(), 1))
+			{
+				// Pawns that stopped simulating (destroyed, fell out of the world) shouldn't hang the run.
+				if(++State.PhaseFrames < State.SimFrames * 10)
+				{
+					return true;
+				}
+				UE_LOGFMT(LogMover, Warning, "FG.Bench.Scale - Only {Ticks} sim ticks after {Frames} frames, cutting {Pawns} pawns short",
+					NumSimTicks, State.PhaseFrames, State.Counts[State.CountIdx]);
+			}
+
+			FinishCount(State, *World);
+			++State.CountIdx;
+			State.Phase = FState::EPhase::Spawn;
+			return true;
+		}
+		}
+
+		return false;
+	}
+
+	static FAutoConsoleCommand CmdBenchScale(
+		TEXT("FG.Bench.Scale"),
+		TEXT("Spawns 100/500/1000/2000 synthetic FG pawns in turn, runs a number of sim frames each and reports movement ms p50/p95/p99, sweeps and memory per pawn to Saved/FGMovement. ")
+		TEXT("Usage: FG.Bench.Scale [Frames=600] [Counts=100,500,1000,2000] [Movement=Mixed] [Seed=0] [Spacing=300] [Warmup=60] [Arena=0] [Quit=0]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if(TickerHandle.IsValid())
+			{
+				UE_LOGFMT(LogMover, Warning, "FG.Bench.Scale - Already running");
+				return;
+			}
+
+			UWorld* World = FG::SyntheticInput::FindAuthorityWorld();
+			if(!World)
+			{
+				UE_LOGFMT(LogMover, Warning, "FG.Bench.Scale - No server or standalone game world");
+				return;
+			}
+
+			TSharedRef<FState> State = MakeShared<FState>();
+			State->World = World;
+
+			const FString Params = FString::Join(Args, TEXT(" "));
+			FParse::Value(*Params, TEXT("Frames="), State->SimFrames);
+			FParse::Value(*Params, TEXT("Seed="), State->Seed);
+			FParse::Value(*Params, TEXT("Spacing="), State->Spacing);
+			FParse::Value(*Params, TEXT("Warmup="), State->WarmupFrames);
+			FParse::Bool(*Params, TEXT("Quit="), State->bQuit);
+
+			State->SimFrames = FMath::Max(State->SimFrames, 1);
+			State->WarmupFrames = FMath::Max(State->WarmupFrames, 1);
+
+			FString MovementName;
+			if(FParse::Value(*Params, TEXT("Movement="), MovementName))
+			{
+				const int64 Value = StaticEnum<EFGSyntheticMovement>()->GetValueByNameString(MovementName);
+				if(Value != INDEX_NONE)
+				{
+					State->Movement = static_cast<EFGSyntheticMovement>(Value);
+				}
+			}
+
+			FString CountList;
+			if(FParse::Value(*Params, TEXT("Counts="), CountList, false))
+			{
+				TArray<FString> Tokens;
+				CountList.ParseIntoArray(Tokens, TEXT(","));
+				for(const FString& Token : Tokens)
+				{
+					const int32 Count = FCString::Atoi(*Token);
+					if(Count > 0)
+					{
+						State->Counts.Add(Count);
+					}
+				}
+			}
+			if(State->Counts.IsEmpty())
+			{
+				State->Counts = { 100, 500, 1000, 2000 };
+			}
+
+			bool bArena = false;
+			FParse::Bool(*Params, TEXT("Arena="), bArena);
+			if(bArena)
+			{
+				const int32 MaxCount = FMath::Max(State->Counts);
+				const float GridExtent = FMath::CeilToFloat(FMath::Sqrt(static_cast<float>(MaxCount))) * State->Spacing * 0.5f;
+				SpawnArena(*World, FindOrigin(*World), GridExtent + 2000.0f);
+			}
+
+			// Leftovers of an earlier run would skew the first count.
+			FG::SyntheticInput::DestroyPawns(*World);
+
+			UE_LOGFMT(LogMover, Log, "FG.Bench.Scale - {Num} pawn counts, {Frames} sim frames each", State->Counts.Num(), State->SimFrames);
+
+			StartTiming(*State, *World);
+
+			TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([State](float)
+			{
+				const bool bRunning = Step(*State);
+				if(!bRunning)
+				{
+					StopTiming(*State);
+					TickerHandle.Reset();
+				}
+				return bRunning;
+			}));
+		}));
+}
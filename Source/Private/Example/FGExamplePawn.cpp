@@ -38,6 +38,13 @@ void AFGExamplePawn::SetupPlayerInputComponent(UInputComponent* PlayerInputCompo
 		const UInputAction* DuckAction = AssetData->InputActionCrouch.LoadSynchronous();
 		EIC->BindAction(DuckAction, ETriggerEvent::Triggered, this, &ThisClass::Crouch);
 		EIC->BindAction(DuckAction, ETriggerEvent::Completed, this, &ThisClass::CrouchCompleted);
+
+		// Sprint is optional, the example content doesn't ship an action for it.
+		if (const UInputAction* SprintAction = AssetData->InputActionSprint.LoadSynchronous())
+		{
+			EIC->BindAction(SprintAction, ETriggerEvent::Triggered, this, &ThisClass::Sprint);
+			EIC->BindAction(SprintAction, ETriggerEvent::Completed, this, &ThisClass::SprintCompleted);
+		}
 	}
 }
 
@@ -11,11 +11,11 @@
 
 namespace FG::CVars
 {
-	bool DrawMovementDebug = true;
+	bool DrawMovementDebug = false;
 	FAutoConsoleVariableRef CVarDrawMovementDebug(
 		TEXT("FG.DrawMovementDebug"),
 		DrawMovementDebug,
-		TEXT("Draws debug helpers for FG Movement (0/1)."),
+		TEXT("Draws trails, floor normals and velocities of the movers picked with FG.Debug.Draw (0/1)."),
 		ECVF_Default);
 	
 	float JumpForce = 300.0f;
@@ -105,4 +105,228 @@ namespace FG::CVars
 		TEXT("Constant gravity speed to apply."),
 		ECVF_Default
 	);
+
+	float TickBudgetUs = 0.0f;
+	FAutoConsoleVariableRef CVarTickBudgetUs(
+		TEXT("FG.Budget.TickUs"),
+		TickBudgetUs,
+		TEXT("Wall time budget in microseconds for a single FG mode tick (generate + simulate). 0 disables the check."),
+		ECVF_Default
+	);
+
+	int32 TickSweepBudget = 0;
+	FAutoConsoleVariableRef CVarTickSweepBudget(
+		TEXT("FG.Budget.TickSweeps"),
+		TickSweepBudget,
+		TEXT("Maximum number of collision sweeps for a single FG mode tick. 0 disables the check."),
+		ECVF_Default
+	);
+
+	bool FloorCacheEnabled = true;
+	FAutoConsoleVariableRef CVarFloorCacheEnabled(
+		TEXT("FG.FloorCache.Enable"),
+		FloorCacheEnabled,
+		TEXT("Reuse the last floor hit while a mover slides along the same floor - anywhere on the face of a box, within FG.FloorCache.ReuseDistance on anything else (0/1)."),
+		ECVF_Default
+	);
+
+	int32 FloorCacheMaxReuse = 8;
+	FAutoConsoleVariableRef CVarFloorCacheMaxReuse(
+		TEXT("FG.FloorCache.MaxReuse"),
+		FloorCacheMaxReuse,
+		TEXT("Maximum number of ticks a cached floor hit is reused for before forcing a real sweep."),
+		ECVF_Default
+	);
+
+	float FloorCacheTolerance = 0.1f;
+	FAutoConsoleVariableRef CVarFloorCacheTolerance(
+		TEXT("FG.FloorCache.Tolerance"),
+		FloorCacheTolerance,
+		TEXT("How far (cm) a mover may move off the cached floor plane and still reuse the cached floor hit."),
+		ECVF_Default
+	);
+
+	float FloorCacheReuseDistance = 10.0f;
+	FAutoConsoleVariableRef CVarFloorCacheReuseDistance(
+		TEXT("FG.FloorCache.ReuseDistance"),
+		FloorCacheReuseDistance,
+		TEXT("How far (cm) along the floor plane a mover may slide from where it last swept and still reuse a floor hit that isn't on a box face, e.g. a mesh. 0 only reuses box faces."),
+		ECVF_Default
+	);
+
+	bool FlightRecorderEnabled = false;
+	FAutoConsoleVariableRef CVarFlightRecorderEnabled(
+		TEXT("FG.Recorder.Enable"),
+		FlightRecorderEnabled,
+		TEXT("Record a binary flight sample per FG mode tick into each mover's ring buffer, see FG.Recorder.Dump (0/1)."),
+		ECVF_Default
+	);
+
+	bool ProxyLODEnabled = true;
+	FAutoConsoleVariableRef CVarProxyLODEnabled(
+		TEXT("FG.LOD.Enable"),
+		ProxyLODEnabled,
+		TEXT("Lower the update rate of simulated proxies that are far away or offscreen (0/1)."),
+		ECVF_Default
+	);
+
+	float ProxyLODNearDistance = 3000.0f;
+	FAutoConsoleVariableRef CVarProxyLODNearDistance(
+		TEXT("FG.LOD.NearDistance"),
+		ProxyLODNearDistance,
+		TEXT("Visible simulated proxies closer than this (cm) to a local viewpoint run at full fidelity."),
+		ECVF_Default
+	);
+
+	float ProxyLODFarDistance = 10000.0f;
+	FAutoConsoleVariableRef CVarProxyLODFarDistance(
+		TEXT("FG.LOD.FarDistance"),
+		ProxyLODFarDistance,
+		TEXT("Simulated proxies further than this (cm) from every local viewpoint drop to minimal fidelity."),
+		ECVF_Default
+	);
+
+	float ProxyLODOffscreenTime = 0.5f;
+	FAutoConsoleVariableRef CVarProxyLODOffscreenTime(
+		TEXT("FG.LOD.OffscreenTime"),
+		ProxyLODOffscreenTime,
+		TEXT("Seconds a simulated proxy must go unrendered before it counts as offscreen."),
+		ECVF_Default
+	);
+
+	float ProxyLODMinimalInterval = 0.5f;
+	FAutoConsoleVariableRef CVarProxyLODMinimalInterval(
+		TEXT("FG.LOD.MinimalInterval"),
+		ProxyLODMinimalInterval,
+		TEXT("Seconds between snapshots applied to simulated proxies at minimal fidelity."),
+		ECVF_Default
+	);
+
+	bool RestEnabled = true;
+	FAutoConsoleVariableRef CVarRestEnabled(
+		TEXT("FG.Rest.Enable"),
+		RestEnabled,
+		TEXT("Let idle walking movers go to rest and skip their floor and collision work until woken (0/1)."),
+		ECVF_Default
+	);
+
+	int32 RestTicks = 15;
+	FAutoConsoleVariableRef CVarRestTicks(
+		TEXT("FG.Rest.Ticks"),
+		RestTicks,
+		TEXT("Number of idle walk ticks in a row before a mover goes to rest."),
+		ECVF_Default
+	);
+
+	float RestVelocity = 1.0f;
+	FAutoConsoleVariableRef CVarRestVelocity(
+		TEXT("FG.Rest.Velocity"),
+		RestVelocity,
+		TEXT("Speed (cm/s) under which a walking mover with no input counts as idle."),
+		ECVF_Default
+	);
+
+	bool BallisticEnabled = true;
+	FAutoConsoleVariableRef CVarBallisticEnabled(
+		TEXT("FG.Air.Ballistic"),
+		BallisticEnabled,
+		TEXT("Skip the per tick static sweeps of airborne movers with no air control while they stay inside one static sweep along their ballistic arc. Movable primitives are still swept every tick (0/1)."),
+		ECVF_Default
+	);
+
+	float BallisticHorizon = 0.3f;
+	FAutoConsoleVariableRef CVarBallisticHorizon(
+		TEXT("FG.Air.BallisticHorizon"),
+		BallisticHorizon,
+		TEXT("Seconds of ballistic arc covered by a single sweep. Longer arcs need fewer sweeps but inflate the sweep more."),
+		ECVF_Default
+	);
+
+	int32 SlideMaxPlanes = 4;
+	FAutoConsoleVariableRef CVarSlideMaxPlanes(
+		TEXT("FG.Slide.MaxPlanes"),
+		SlideMaxPlanes,
+		TEXT("Number of contact planes a single slide clips the move against (1-8)."),
+		ECVF_Default
+	);
+
+	int32 SlideMaxSweeps = 3;
+	FAutoConsoleVariableRef CVarSlideMaxSweeps(
+		TEXT("FG.Slide.MaxSweeps"),
+		SlideMaxSweeps,
+		TEXT("Hard cap on the sweeps a single slide may use per tick, whatever is left of the move after that is dropped."),
+		ECVF_Default
+	);
+
+	float SurfMinNormalZ = 0.1f;
+	FAutoConsoleVariableRef CVarSurfMinNormalZ(
+		TEXT("FG.Surf.MinNormalZ"),
+		SurfMinNormalZ,
+		TEXT("Unwalkable surfaces with a normal Z at least this are surfed on, anything steeper is a wall."),
+		ECVF_Default
+	);
+
+	float SurfWalkHysteresis = 0.03f;
+	FAutoConsoleVariableRef CVarSurfWalkHysteresis(
+		TEXT("FG.Surf.WalkHysteresis"),
+		SurfWalkHysteresis,
+		TEXT("How much flatter than the walkable slope limit (normal Z) a surface must be to walk off a ramp onto it."),
+		ECVF_Default
+	);
+
+	float WalkSnapDistance = 20.0f;
+	FAutoConsoleVariableRef CVarWalkSnapDistance(
+		TEXT("FG.Walk.SnapDistance"),
+		WalkSnapDistance,
+		TEXT("How far (cm) down a walking mover that lost its floor looks for a walkable floor to snap onto. 0 disables snapping."),
+		ECVF_Default
+	);
+
+	int32 WalkLostFloorTicks = 2;
+	FAutoConsoleVariableRef CVarWalkLostFloorTicks(
+		TEXT("FG.Walk.LostFloorTicks"),
+		WalkLostFloorTicks,
+		TEXT("Walk ticks in a row without a floor to snap to before a mover switches to Air (1-3). It falls and slides like Air in between."),
+		ECVF_Default
+	);
+
+	bool ParallelFloorBatch = true;
+	FAutoConsoleVariableRef CVarParallelFloorBatch(
+		TEXT("FG.Parallel.FloorBatch"),
+		ParallelFloorBatch,
+		TEXT("Sweep for every FG mover's next floor in one batch at the end of the frame, split over FG.Parallel.Tasks tasks."),
+		ECVF_Default
+	);
+
+	int32 ParallelTasks = 0;
+	FAutoConsoleVariableRef CVarParallelTasks(
+		TEXT("FG.Parallel.Tasks"),
+		ParallelTasks,
+		TEXT("How many tasks FG.Parallel.FloorBatch splits its sweeps over. 0 = one per worker thread, 1 = serial on the game thread."),
+		ECVF_Default
+	);
+
+	bool FloorHistoryEnabled = true;
+	FAutoConsoleVariableRef CVarFloorHistoryEnabled(
+		TEXT("FG.FloorHistory.Enable"),
+		FloorHistoryEnabled,
+		TEXT("Remember the floor of each sim frame, and reuse it when the frame is replayed after a correction."),
+		ECVF_Default
+	);
+
+	float FloorHistoryTolerance = 0.1f;
+	FAutoConsoleVariableRef CVarFloorHistoryTolerance(
+		TEXT("FG.FloorHistory.Tolerance"),
+		FloorHistoryTolerance,
+		TEXT("How far (cm) a replayed frame may start from where it started the first time and still reuse its floor."),
+		ECVF_Default
+	);
+
+	float InputReplayTolerance = 1.0f;
+	FAutoConsoleVariableRef CVarInputReplayTolerance(
+		TEXT("FG.Input.ReplayTolerance"),
+		InputReplayTolerance,
+		TEXT("How far (cm) an FG.Input.Replay may drift from the recorded trajectory before it's reported as diverged."),
+		ECVF_Default
+	);
 }
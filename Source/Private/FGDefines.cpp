@@ -13,6 +13,35 @@ namespace FG::Modes
 {
 	const FLazyName Air		= TEXT("Air");
 	const FLazyName Walk	= TEXT("Walk");
+	const FLazyName Surf	= TEXT("Surf");
+
+	EFGModeId ToId(const FName& ModeName)
+	{
+		if(ModeName == Walk)
+		{
+			return EFGModeId::Walk;
+		}
+		if(ModeName == Air)
+		{
+			return EFGModeId::Air;
+		}
+		if(ModeName == Surf)
+		{
+			return EFGModeId::Surf;
+		}
+		return EFGModeId::None;
+	}
+
+	FName ToName(EFGModeId ModeId)
+	{
+		switch(ModeId)
+		{
+		case EFGModeId::Walk:	return Walk;
+		case EFGModeId::Air:	return Air;
+		case EFGModeId::Surf:	return Surf;
+		default:				return NAME_None;
+		}
+	}
 }
 
 namespace FG::Blackboard
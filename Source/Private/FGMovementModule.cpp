@@ -8,7 +8,30 @@
 // SOFTWARE.
 
 #include "Modules/ModuleInterface.h"
+#include "FGMovementTrace.h"
+#include "Core/FGMovementSettings.h"
+#include "Misc/CoreDelegates.h"
 
-class FFGMovementModule : public IModuleInterface {};
+class FFGMovementModule : public IModuleInterface
+{
+public:
 
-IMPLEMENT_MODULE(FFGMovementModule, FGMovement)
\ No newline at end of file
+	//~ Begin IModuleInterface
+	virtual void StartupModule() override
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FG::Trace::FlushFrameCounters);
+		FG::Tuning::RefreshCVarOverrides();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	}
+	//~ End IModuleInterface
+
+private:
+
+	FDelegateHandle EndFrameHandle;
+};
+
+IMPLEMENT_MODULE(FFGMovementModule, FGMovement)
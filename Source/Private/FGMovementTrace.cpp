@@ -0,0 +1,111 @@
+// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "FGMovementTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(FGMovementChannel);
+CSV_DEFINE_CATEGORY_MODULE(FGMOVEMENT_API, FGMovement, true);
+
+TRACE_DECLARE_INT_COUNTER(FGMovement_SimTicks,			TEXT("FGMovement/SimTicks"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_Sweeps,			TEXT("FGMovement/Sweeps"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_SlideIterations,	TEXT("FGMovement/SlideIterations"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_ModeTransitions,	TEXT("FGMovement/ModeTransitions"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_WalkAirTransitions,	TEXT("FGMovement/WalkAirTransitions"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_Teleports,			TEXT("FGMovement/Teleports"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_LayeredMoves,		TEXT("FGMovement/LayeredMovesQueued"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_HeapAllocs,		TEXT("FGMovement/HeapAllocations"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_RestTicks,			TEXT("FGMovement/RestTicks"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_BallisticTicks,	TEXT("FGMovement/BallisticTicks"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_FloorPrefetchHits,	TEXT("FGMovement/FloorPrefetchHits"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_FloorPrefetchMisses,	TEXT("FGMovement/FloorPrefetchMisses"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_ResimTicks,		TEXT("FGMovement/ResimTicks"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_FloorHistoryHits,	TEXT("FGMovement/FloorHistoryHits"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_Movers,			TEXT("FGMovement/Movers"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_ProxiesFull,		TEXT("FGMovement/ProxiesFull"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_ProxiesReduced,	TEXT("FGMovement/ProxiesReduced"));
+TRACE_DECLARE_INT_COUNTER(FGMovement_ProxiesMinimal,	TEXT("FGMovement/ProxiesMinimal"));
+
+namespace FG::Trace
+{
+	FFrameCounters FrameCounters;
+
+	void FlushFrameCounters()
+	{
+		const int32 SimTicks			= FrameCounters.SimTicks.exchange(0, std::memory_order_relaxed);
+		const int32 Sweeps				= FrameCounters.Sweeps.exchange(0, std::memory_order_relaxed);
+		const int32 SlideIterations		= FrameCounters.SlideIterations.exchange(0, std::memory_order_relaxed);
+		const int32 ModeTransitions		= FrameCounters.ModeTransitions.exchange(0, std::memory_order_relaxed);
+		const int32 WalkAirTransitions	= FrameCounters.WalkAirTransitions.exchange(0, std::memory_order_relaxed);
+		const int32 Teleports			= FrameCounters.Teleports.exchange(0, std::memory_order_relaxed);
+		const int32 LayeredMovesQueued	= FrameCounters.LayeredMovesQueued.exchange(0, std::memory_order_relaxed);
+		const int32 HeapAllocations		= FrameCounters.HeapAllocations.exchange(0, std::memory_order_relaxed);
+		const int32 RestTicks			= FrameCounters.RestTicks.exchange(0, std::memory_order_relaxed);
+		const int32 BallisticTicks		= FrameCounters.BallisticTicks.exchange(0, std::memory_order_relaxed);
+		const int32 FloorPrefetchHits	= FrameCounters.FloorPrefetchHits.exchange(0, std::memory_order_relaxed);
+		const int32 FloorPrefetchMisses	= FrameCounters.FloorPrefetchMisses.exchange(0, std::memory_order_relaxed);
+		const int32 ResimTicks			= FrameCounters.ResimTicks.exchange(0, std::memory_order_relaxed);
+		const int32 FloorHistoryHits	= FrameCounters.FloorHistoryHits.exchange(0, std::memory_order_relaxed);
+		const int32 NumMovers			= FrameCounters.NumMovers.load(std::memory_order_relaxed);
+		const int32 ProxiesFull			= FrameCounters.ProxiesFull.load(std::memory_order_relaxed);
+		const int32 ProxiesReduced		= FrameCounters.ProxiesReduced.load(std::memory_order_relaxed);
+		const int32 ProxiesMinimal		= FrameCounters.ProxiesMinimal.load(std::memory_order_relaxed);
+
+#if COUNTERSTRACE_ENABLED
+		TRACE_COUNTER_SET(FGMovement_SimTicks, SimTicks);
+		TRACE_COUNTER_SET(FGMovement_Sweeps, Sweeps);
+		TRACE_COUNTER_SET(FGMovement_SlideIterations, SlideIterations);
+		TRACE_COUNTER_SET(FGMovement_ModeTransitions, ModeTransitions);
+		TRACE_COUNTER_SET(FGMovement_WalkAirTransitions, WalkAirTransitions);
+		TRACE_COUNTER_SET(FGMovement_Teleports, Teleports);
+		TRACE_COUNTER_SET(FGMovement_LayeredMoves, LayeredMovesQueued);
+		TRACE_COUNTER_SET(FGMovement_HeapAllocs, HeapAllocations);
+		TRACE_COUNTER_SET(FGMovement_RestTicks, RestTicks);
+		TRACE_COUNTER_SET(FGMovement_BallisticTicks, BallisticTicks);
+		TRACE_COUNTER_SET(FGMovement_FloorPrefetchHits, FloorPrefetchHits);
+		TRACE_COUNTER_SET(FGMovement_FloorPrefetchMisses, FloorPrefetchMisses);
+		TRACE_COUNTER_SET(FGMovement_ResimTicks, ResimTicks);
+		TRACE_COUNTER_SET(FGMovement_FloorHistoryHits, FloorHistoryHits);
+		TRACE_COUNTER_SET(FGMovement_Movers, NumMovers);
+		TRACE_COUNTER_SET(FGMovement_ProxiesFull, ProxiesFull);
+		TRACE_COUNTER_SET(FGMovement_ProxiesReduced, ProxiesReduced);
+		TRACE_COUNTER_SET(FGMovement_ProxiesMinimal, ProxiesMinimal);
+#endif
+
+#if CSV_PROFILER
+		CSV_CUSTOM_STAT(FGMovement, SimTicks, SimTicks, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, Sweeps, Sweeps, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, SlideIterations, SlideIterations, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, ModeTransitions, ModeTransitions, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, WalkAirTransitions, WalkAirTransitions, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, Teleports, Teleports, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, LayeredMovesQueued, LayeredMovesQueued, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, HeapAllocations, HeapAllocations, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, RestTicks, RestTicks, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, BallisticTicks, BallisticTicks, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, FloorPrefetchHits, FloorPrefetchHits, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, FloorPrefetchMisses, FloorPrefetchMisses, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, ResimTicks, ResimTicks, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, FloorHistoryHits, FloorHistoryHits, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, Movers, NumMovers, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, ProxiesFull, ProxiesFull, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, ProxiesReduced, ProxiesReduced, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, ProxiesMinimal, ProxiesMinimal, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(FGMovement, SweepsPerMover, NumMovers > 0 ? float(Sweeps) / NumMovers : 0.0f, ECsvCustomStatOp::Set);
+#endif
+
+#if !COUNTERSTRACE_ENABLED && !CSV_PROFILER
+		(void)SimTicks; (void)Sweeps; (void)SlideIterations; (void)ModeTransitions;
+		(void)Teleports; (void)LayeredMovesQueued; (void)HeapAllocations; (void)NumMovers;
+		(void)ProxiesFull; (void)ProxiesReduced; (void)ProxiesMinimal; (void)RestTicks; (void)BallisticTicks; (void)WalkAirTransitions;
+		(void)FloorPrefetchHits; (void)FloorPrefetchMisses;
+		(void)ResimTicks; (void)FloorHistoryHits;
+#endif
+	}
+}
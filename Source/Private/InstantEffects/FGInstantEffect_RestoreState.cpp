@@ -0,0 +1,82 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "InstantEffects/FGInstantEffect_RestoreState.h"
+#include "Core/FGDataModel.h"
+#include "FGMovementTrace.h"
+#include "MoverComponent.h"
+#include "MoverSimulationTypes.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FGInstantEffect_RestoreState)
+
+bool FFGInstantEffect_RestoreState::ApplyMovementEffect(FApplyMovementEffectParams& ApplyEffectParams, FMoverSyncState& OutputState)
+{
+	FG_SCOPE_CYCLE(FG::RestoreStateEffect);
+
+	USceneComponent* UpdatedComponent = ApplyEffectParams.UpdatedComponent;
+	const FName ModeName = FG::Modes::ToName(ModeId);
+	if(!UpdatedComponent || ModeName.IsNone() || !UpdatedComponent->GetOwner()->TeleportTo(Location, Rotation))
+	{
+		return false;
+	}
+
+	FG::Trace::Count(FG::Trace::FrameCounters.Teleports);
+
+	FFGMoverSyncState& OutputSyncState = OutputState.SyncStateCollection.FindOrAddMutableDataByType<FFGMoverSyncState>();
+	OutputSyncState.SetTransforms_WorldSpace(UpdatedComponent->GetComponentLocation(),
+		UpdatedComponent->GetComponentRotation(),
+		Velocity,
+		nullptr); // no movement base
+
+	// Start over, whatever the mover was counting towards.
+	OutputSyncState.FloorlessTicks = 0;
+	OutputSyncState.IdleTicks = 0;
+	OutputSyncState.bResting = false;
+	OutputSyncState.Quantize();
+
+	OutputState.MovementMode = ModeName;
+	UpdatedComponent->ComponentVelocity = OutputSyncState.GetVelocity_WorldSpace();
+	return true;
+}
+
+FInstantMovementEffect* FFGInstantEffect_RestoreState::Clone() const
+{
+	FFGInstantEffect_RestoreState* CopyPtr = new FFGInstantEffect_RestoreState(*this);
+	return CopyPtr;
+}
+
+void FFGInstantEffect_RestoreState::NetSerialize(FArchive& Ar)
+{
+	FInstantMovementEffect::NetSerialize(Ar);
+
+	uint8 Mode = static_cast<uint8>(ModeId);
+
+	Ar << Location;
+	Ar << Rotation;
+	Ar << Velocity;
+	Ar << Mode;
+
+	ModeId = static_cast<EFGModeId>(Mode);
+}
+
+UScriptStruct* FFGInstantEffect_RestoreState::GetScriptStruct() const
+{
+	return FFGInstantEffect_RestoreState::StaticStruct();
+}
+
+FString FFGInstantEffect_RestoreState::ToSimpleString() const
+{
+	return FString::Printf(TEXT("Restore State (%s)"), *FG::Modes::ToName(ModeId).ToString());
+}
+
+void FFGInstantEffect_RestoreState::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	FInstantMovementEffect::AddReferencedObjects(Collector);
+}
@@ -8,12 +8,16 @@
 // SOFTWARE.
 
 #include "LayeredMoves/FGLayeredMove_Crouch.h"
+#include "Core/FGMovementUtils.h"
+#include "Core/FGMoverComponent.h"
 #include "FGMovementCVars.h"
 #include "MoverComponent.h"
 #include "MoverDataModelTypes.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FGLayeredMove_Crouch)
 
+FG_IMPLEMENT_POOLED_ALLOCATOR(FFGLayeredMove_Crouch)
+
 FFGLayeredMove_Crouch::FFGLayeredMove_Crouch()
 {
 	DurationMs = 0.f;
@@ -28,7 +32,10 @@ bool FFGLayeredMove_Crouch::GenerateMove(const FMoverTickStartData& StartState,
 	checkf(MixMode == EMoveMixMode::OverrideVelocity, TEXT("Only OverrideVelocity is supported for crouch move."));
 	const FVector PriorVelocityWS = SyncState->GetVelocity_WorldSpace();
 
-	OutProposedMove.LinearVelocity = PriorVelocityWS * FG::CVars::CrouchSpeedMult; // Rescale velocity by crouch speed.
+	const UFGMoverComponent* FGMoverComp = Cast<UFGMoverComponent>(MoverComp);
+	const float CrouchSpeedMult = FGMoverComp ? FG::GetTuning(*FGMoverComp).CrouchSpeedMult : FG::CVars::CrouchSpeedMult;
+
+	OutProposedMove.LinearVelocity = PriorVelocityWS * CrouchSpeedMult; // Rescale velocity by crouch speed.
 
 	return true;
 }
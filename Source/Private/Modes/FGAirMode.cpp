@@ -8,12 +8,14 @@
 // SOFTWARE.
 
 #include "Modes/FGAirMode.h"
+#include "Modes/FGModeTick.h"
 
 #include "FGMovementCVars.h"
 #include "Core/FGDataModel.h"
 #include "Core/FGMovementUtils.h"
 #include "Core/FGMoverComponent.h"
 #include "FGMovementDefines.h"
+#include "FGMovementTrace.h"
 
 #include "Components/CapsuleComponent.h"
 #include "MoveLibrary/MovementUtils.h"
@@ -22,6 +24,64 @@
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FGAirMode)
 
+namespace FG::Modes
+{
+	/** Falling - air constants and gravity, lands on the first walkable floor. */
+	struct FAirPolicy
+	{
+		static constexpr EFGModeId		ModeId			= EFGModeId::Air;
+		static constexpr EFGMoveSurface	Surface			= EFGMoveSurface::Air;
+		static constexpr bool			bApplyDamping	= false;
+		static constexpr bool			bApplyGravity	= true;
+		static constexpr bool			bCanRest		= false;
+		static constexpr bool			bCanJump		= false;
+		static constexpr bool			bFollowSurface	= false;
+		static constexpr bool			bBallistic		= true;
+
+		static FORCEINLINE FVector GetAccelerationDirection(const FFGMovementContext& Ctx, const FVector& MoveInputWS)
+		{
+			return MoveInputWS;
+		}
+
+		static FORCEINLINE float GetDesiredSpeed(const FFGMovementContext& Ctx)
+		{
+			return Ctx.Tuning.AirSpeed;
+		}
+
+		static FORCEINLINE void PreMove(UFGAirMode& Mode, const FFGMovementContext& Ctx, FMoverTickEndData& OutputState, EFGTransitionReason& OutReason)
+		{
+		}
+
+		static FORCEINLINE void PostMove(UFGAirMode& Mode, const FFGMovementContext& Ctx, FG::ModeTick::FMoveStep& Step, FMoverTickEndData& OutputState, EFGTransitionReason& OutReason)
+		{
+			if(Step.Hit.bBlockingHit)
+			{
+				FG::SlideAlongSurfaces(
+					Ctx.CostStats,
+					Ctx.UpdatedComponent,
+					Ctx.UpdatedPrimitive,
+					Step.MoveDelta,
+					Step.OrientQuat,
+					Step.Hit,
+					Step.MoveRecord);
+			}
+
+			if(Step.Floor.bWalkableFloor)
+			{
+				FMoverOnImpactParams ImpactParams(FG::Modes::Air, Step.Hit, Step.MoveDelta);
+				Ctx.MoverComp.HandleImpact(ImpactParams);
+				OutputState.MovementEndState.NextModeName = FG::Modes::Walk;
+				OutReason = EFGTransitionReason::Landed;
+			}
+			else if(FG::ModeTick::IsSurfable(Step.Floor))
+			{
+				OutputState.MovementEndState.NextModeName = FG::Modes::Surf;
+				OutReason = EFGTransitionReason::Surf;
+			}
+		}
+	};
+}
+
 /**
  * Generate a single substep of movement for the mode - remember this is sub-stepping against
  * network prediction plugins tick and NOT the game thread tick. This function would typically
@@ -34,33 +94,10 @@
  */
 void UFGAirMode::OnGenerateMove(const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, FProposedMove& OutProposedMove) const
 {
-	const FFGMoverInputCmd* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FFGMoverInputCmd>();
-	const FMoverDefaultSyncState* StartingSyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
-	check(StartingSyncState);
-
-	OutProposedMove.LinearVelocity = StartingSyncState->GetVelocity_WorldSpace();
-	const float DeltaTime = TimeStep.StepMs * 0.001f;
-
-	constexpr float TurningRateLimit = 5000.0f;
-	
-	// @TODO: This is going to break if the player isn't Z up. Works for now.
-	OutProposedMove.AngularVelocity = UMovementUtils::ComputeAngularVelocity(
-		StartingSyncState->GetOrientation_WorldSpace(),
-		CharacterInputs->GetOrientationIntentDir_WorldSpace().ToOrientationRotator(),
-		DeltaTime,
-		TurningRateLimit);
-
-	UE_LOGFMT(LogMover, Display, "Angular Velocity: {AngVel}", *OutProposedMove.AngularVelocity.ToString());
-
-	OutProposedMove.DirectionIntent = CharacterInputs->GetOrientationIntentDir_WorldSpace();
+	FG_SCOPE_CYCLE(UFGAirMode::OnGenerateMove);
+	CSV_SCOPED_TIMING_STAT(FGMovement, GenerateMove);
 
-	FVector MoveInputWS = OutProposedMove.DirectionIntent.ToOrientationRotator().RotateVector(CharacterInputs->GetMoveInput());
-	
-	UFGMovementUtils::ApplyAcceleration(CastChecked<UFGMoverComponent>(GetOuter()), OutProposedMove, DeltaTime, MoveInputWS, FG::CVars::AirSpeed);
-
-	OutProposedMove.LinearVelocity -= FVector::UpVector * FG::CVars::GravitySpeed * DeltaTime;
-
-    UE_LOGFMT(LogMover, Display, "Linear Velocity: {LinVel}", *OutProposedMove.LinearVelocity.ToString());
+	FG::ModeTick::GenerateMove<FG::Modes::FAirPolicy>(*this, StartState, TimeStep, OutProposedMove);
 }
 
 /**
@@ -74,88 +111,8 @@ void UFGAirMode::OnGenerateMove(const FMoverTickStartData& StartState, const FMo
  */
 void UFGAirMode::OnSimulationTick(const FSimulationTickParams& Params, FMoverTickEndData& OutputState)
 {
-	const FMoverTickStartData& StartState = Params.StartState;
-	USceneComponent* UpdatedComponent = Params.UpdatedComponent;
-	UPrimitiveComponent* UpdatedPrimitive = Params.UpdatedPrimitive;
-	FProposedMove ProposedMove = Params.ProposedMove;
-
-	const FMoverDefaultSyncState* StartingSyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
-	check(StartingSyncState);
-
-	FMoverDefaultSyncState& OutputSyncState = OutputState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FMoverDefaultSyncState>();
-	
-	const float DeltaSeconds = Params.TimeStep.StepMs * 0.001f;
-
-	// Instantaneous movement changes that are executed and we exit before consuming any time
-	if (ProposedMove.bHasTargetLocation && FG::AttemptTeleport(UpdatedComponent, ProposedMove.TargetLocation, UpdatedComponent->GetComponentRotation(), *StartingSyncState, OutputState))
-	{
-		OutputState.MovementEndState.RemainingMs = Params.TimeStep.StepMs; 	// Give back all the time
-		return;
-	}
-
-	FMovementRecord MoveRecord;
-	MoveRecord.SetDeltaSeconds(DeltaSeconds);
-
-	UMoverBlackboard* SimBlackboard = GetBlackboard_Mutable();
-	SimBlackboard->Invalidate(CommonBlackboard::LastFloorResult); // Flush last floor result.
-
-	constexpr float FloorSweepDist = 1.f;
-	constexpr float MaxWalkSlopeCosine = 0.71f;
-
-	FFloorCheckResult NewFloor;
-	
-	// If we don't have cached floor information, we need to search for it again
-	UFloorQueryUtils::FindFloor(UpdatedComponent, UpdatedPrimitive, FloorSweepDist,
-		MaxWalkSlopeCosine, UpdatedPrimitive->GetComponentLocation(), NewFloor);
-
-	SimBlackboard->Set(CommonBlackboard::LastFloorResult, NewFloor);
-	
-	OutputSyncState.MoveDirectionIntent = (ProposedMove.bHasDirIntent ? ProposedMove.DirectionIntent : FVector::ZeroVector);
-
-	// Use the orientation intent directly. If no intent is provided, use last frame's orientation. Note that we are assuming rotation changes can't fail. 
-	const FRotator StartingOrient = StartingSyncState->GetOrientation_WorldSpace();
-	FRotator TargetOrient = StartingOrient;
-
-	bool bIsOrientationChanging = false;
-
-	// Apply orientation changes (if any)
-	if (!ProposedMove.AngularVelocity.IsZero())
-	{
-		TargetOrient += (ProposedMove.AngularVelocity * DeltaSeconds);
-		bIsOrientationChanging = (TargetOrient != StartingOrient);
-	}
-	
-	FVector MoveDelta = ProposedMove.LinearVelocity * DeltaSeconds;
-	const FQuat OrientQuat = TargetOrient.Quaternion();
-
-	FHitResult Hit(1.f);
-
-	if (!MoveDelta.IsNearlyZero() || bIsOrientationChanging)
-	{
-		UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, MoveDelta, OrientQuat, true, Hit, ETeleportType::None, MoveRecord);
-	}
-
-	if(Hit.bBlockingHit)
-	{
-		UMovementUtils::TryMoveToSlideAlongSurface(
-			UpdatedComponent,
-			UpdatedPrimitive,
-			GetMoverComponent(),
-			MoveDelta,
-			1.f - Hit.Time,
-			OrientQuat,
-			Hit.Normal,
-			Hit,
-			false,
-			MoveRecord);
-	}
-	
-	if(NewFloor.bWalkableFloor)
-	{
-		FMoverOnImpactParams ImpactParams(FG::Modes::Air, Hit, MoveDelta);
-		GetMoverComponent()->HandleImpact(ImpactParams);
-		OutputState.MovementEndState.NextModeName = FG::Modes::Walk;
-	}
+	FG_SCOPE_CYCLE(UFGAirMode::OnSimulationTick);
+	CSV_SCOPED_TIMING_STAT(FGMovement, SimulationTick);
 
-	FG::CaptureFinalState(UpdatedComponent, MoveRecord, *StartingSyncState, OutputSyncState, DeltaSeconds);
+	FG::ModeTick::SimulationTick<FG::Modes::FAirPolicy>(*this, Params, OutputState);
 }
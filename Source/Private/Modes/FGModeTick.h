@@ -0,0 +1,359 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Core/FGDataModel.h"
+#include "Core/FGFlightRecorder.h"
+#include "Core/FGMovementContext.h"
+#include "Core/FGMovementStats.h"
+#include "Core/FGMovementUtils.h"
+#include "Core/FGMoverComponent.h"
+#include "FGMovementDefines.h"
+#include "FGMovementTrace.h"
+
+#include "MoveLibrary/FloorQueryUtils.h"
+#include "MoveLibrary/MovementUtils.h"
+#include "MoverComponent.h"
+#include "MovementMode.h"
+
+/**
+ * The generate and simulate bodies shared by the FG modes, specialized at compile time on a
+ * mode policy so the modes can't drift apart and nothing in them branches on the mode.
+ *
+ * A mode policy provides:
+ *		static constexpr EFGModeId		ModeId			- The mode it implements.
+ *		static constexpr EFGMoveSurface	Surface			- Which tuning constants damping and acceleration use.
+ *		static constexpr bool			bApplyDamping
+ *		static constexpr bool			bApplyGravity
+ *		static constexpr bool			bCanRest		- Whether idle movers may go to rest in this mode, see FFGRestState.
+ *		static constexpr bool			bCanJump		- Whether jump input launches the mover straight up at the tuning's JumpForce.
+ *		static constexpr bool			bBallistic		- Whether movers with no input may follow a ballistic arc, see FFGBallisticArc.
+ *		static constexpr bool			bFollowSurface	- Whether the proposed velocity is kept on the plane of the last floor hit.
+ *		static FVector	GetAccelerationDirection(const FFGMovementContext& Ctx, const FVector& MoveInputWS)
+ *		static float	GetDesiredSpeed(const FFGMovementContext& Ctx)
+ *		static void		PreMove(ModeType& Mode, const FFGMovementContext& Ctx, FMoverTickEndData& OutputState, EFGTransitionReason& OutReason)
+ *		static void		PostMove(ModeType& Mode, const FFGMovementContext& Ctx, FG::ModeTick::FMoveStep& Step, FMoverTickEndData& OutputState, EFGTransitionReason& OutReason)
+ */
+namespace FG::ModeTick
+{
+	constexpr float TurningRateLimit	= 5000.0f;
+	constexpr float FloorSweepDist		= 1.0f;
+	constexpr float MaxWalkSlopeCosine	= 0.71f;
+
+	/** @return Whether a floor result is a surface to surf on - blocking, too steep to walk, but not a wall. */
+	FORCEINLINE bool IsSurfable(const FFloorCheckResult& Floor)
+	{
+		return Floor.bBlockingHit && !Floor.bWalkableFloor && Floor.HitResult.ImpactNormal.Z >= FG::CVars::SurfMinNormalZ;
+	}
+
+	/** The outcome of the shared move, handed to the policy to resolve. */
+	struct FMoveStep
+	{
+		const FFloorCheckResult&	Floor;
+		FVector						MoveDelta;
+		FQuat						OrientQuat;
+		FHitResult&					Hit;
+		FMovementRecord&			MoveRecord;
+		uint8						FloorlessTicks;	// Written back to the sync state, only the walk policy counts it.
+	};
+
+	/**
+	 * Take this step with a single sweep against movable primitives if nothing but gravity acts on
+	 * the mover and the step stays inside the static clearance of its ballistic arc, casting a new
+	 * arc when the old one no longer fits. The step is integrated and recorded exactly like the
+	 * full move, so unless static geometry changed since the cast it ends up where the full move
+	 * would - see FFGBallisticArc.
+	 *
+	 * @return Whether the step was taken, otherwise the mode has to run the full move.
+	 */
+	template<typename Policy>
+	FORCEINLINE bool TryBallisticStep(const FFGMovementContext& Ctx, const FSimulationTickParams& Params, FFGMoverSyncState& OutputSyncState)
+	{
+		FFGBallisticArc& Arc = Ctx.MoverComp.GetBallisticArc();
+		const FProposedMove& ProposedMove = Params.ProposedMove;
+
+		// Replays follow the full move, the arc was cast for the frames as they were first simulated.
+		if(!FG::CVars::BallisticEnabled || Ctx.MoverComp.IsResimulating() || Ctx.Input.HasMoveIntent() || ProposedMove.bHasTargetLocation)
+		{
+			Arc.Invalidate();
+			return false;
+		}
+
+		const float DeltaSeconds = Params.TimeStep.StepMs * 0.001f;
+		const float GravitySpeed = Ctx.Tuning.GravitySpeed;
+		const FVector Location = Ctx.UpdatedComponent->GetComponentLocation();
+		const FVector MoveDelta = ProposedMove.LinearVelocity * DeltaSeconds;
+
+		if(!Arc.CanAdvance(Location, Location + MoveDelta))
+		{
+			if(!Arc.ShouldCast())
+			{
+				Arc.Invalidate();
+				return false;
+			}
+
+			// The proposed velocity already has this step's gravity in it.
+			const FVector StartVelocity = ProposedMove.LinearVelocity + FVector::UpVector * (GravitySpeed * DeltaSeconds);
+			Arc.Cast(Ctx.CostStats, Ctx.UpdatedPrimitive, Location, StartVelocity, GravitySpeed, DeltaSeconds, FloorSweepDist);
+
+			if(!Arc.CanAdvance(Location, Location + MoveDelta))
+			{
+				Arc.Invalidate();
+				return false;
+			}
+		}
+
+		// Anything movable in the way, or a movable floor coming up, needs the full move.
+		if(!FFGBallisticArc::SweepDynamic(Ctx.CostStats, Ctx.UpdatedPrimitive, Location, Location + MoveDelta, FloorSweepDist))
+		{
+			return false;
+		}
+
+		// Same move as the full path takes when its sweep comes back clear, minus the static sweeps.
+		// Capsules don't care about yaw, so turning doesn't need one either.
+		const FRotator StartingOrient = Ctx.StartSyncState.GetOrientation_WorldSpace();
+		const FRotator TargetOrient = ProposedMove.AngularVelocity.IsZero() ? StartingOrient : StartingOrient + ProposedMove.AngularVelocity * DeltaSeconds;
+
+		FMovementRecord MoveRecord;
+		MoveRecord.SetDeltaSeconds(DeltaSeconds);
+
+		if(!MoveDelta.IsNearlyZero() || TargetOrient != StartingOrient)
+		{
+			Ctx.UpdatedComponent->SetWorldLocationAndRotation(Location + MoveDelta, TargetOrient.Quaternion(), false, nullptr, ETeleportType::None);
+			MoveRecord.Append(FMovementSubstep(FG::Modes::ToName(Policy::ModeId), Ctx.UpdatedComponent->GetComponentLocation() - Location, true));
+		}
+
+		OutputSyncState.MoveDirectionIntent = (ProposedMove.bHasDirIntent ? ProposedMove.DirectionIntent : FVector::ZeroVector);
+		FG::CaptureFinalState(Ctx, MoveRecord, OutputSyncState);
+
+		// Clear of any floor all the way along the step.
+		Ctx.MoverComp.GetSimBlackboard_Mutable()->Invalidate(CommonBlackboard::LastFloorResult);
+
+		Ctx.MoverComp.GetFlightRecorder().Record(Params.TimeStep, Policy::ModeId, OutputSyncState, &Ctx.Input, nullptr, EFGTransitionReason::None);
+		FG::Trace::Count(FG::Trace::FrameCounters.BallisticTicks);
+		return true;
+	}
+
+	template<typename Policy>
+	FORCEINLINE void GenerateMove(const UBaseMovementMode& Mode, const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, FProposedMove& OutProposedMove)
+	{
+		const FFGMovementContext Ctx(Mode, StartState);
+		FG::FScopedGenerateCost GenerateCost(Ctx.CostStats);
+
+		const FFGMoverInputCmd& CharacterInputs = Ctx.Input;
+
+		if constexpr (Policy::bCanRest)
+		{
+			// Resting, and the input still doesn't ask for anything - propose standing still.
+			if(Ctx.MoverComp.GetRestState().IsResting(Ctx.StartSyncState) && !CharacterInputs.HasMoveIntent()
+				&& CharacterInputs.GetOrientationIntentDir_WorldSpace().Equals(Ctx.StartSyncState.GetOrientation_WorldSpace().Vector()))
+			{
+				OutProposedMove.LinearVelocity = FVector::ZeroVector;
+				OutProposedMove.AngularVelocity = FRotator::ZeroRotator;
+				OutProposedMove.DirectionIntent = CharacterInputs.GetOrientationIntentDir_WorldSpace();
+				return;
+			}
+		}
+
+		OutProposedMove.LinearVelocity = Ctx.StartSyncState.GetVelocity_WorldSpace();
+		const float DeltaTime = TimeStep.StepMs * 0.001f;
+
+		if constexpr (Policy::bApplyDamping)
+		{
+			FG::ApplyDamping<Policy::Surface>(Ctx, OutProposedMove, DeltaTime);
+		}
+
+		// @TODO: This is going to break if the player isn't Z up. Works for now.
+		OutProposedMove.AngularVelocity = UMovementUtils::ComputeAngularVelocity(
+			Ctx.StartSyncState.GetOrientation_WorldSpace(),
+			CharacterInputs.GetOrientationIntentDir_WorldSpace().ToOrientationRotator(),
+			DeltaTime,
+			TurningRateLimit);
+
+		OutProposedMove.DirectionIntent = CharacterInputs.GetOrientationIntentDir_WorldSpace();
+
+		const FVector MoveInputWS = OutProposedMove.DirectionIntent.ToOrientationRotator().RotateVector(CharacterInputs.GetMoveInput());
+
+		FG::ApplyAcceleration<Policy::Surface>(Ctx, OutProposedMove, DeltaTime,
+			Policy::GetAccelerationDirection(Ctx, MoveInputWS), Policy::GetDesiredSpeed(Ctx));
+
+		if constexpr (Policy::bCanJump)
+		{
+			// What a jump impulse layered move would do on the next tick, without a layered move
+			// for Mover to clone into every state it copies.
+			if(CharacterInputs.bIsJumpPressed)
+			{
+				OutProposedMove.LinearVelocity.Z = Ctx.Tuning.JumpForce;
+			}
+		}
+
+		if constexpr (Policy::bApplyGravity)
+		{
+			FG::Kinematics::ApplyGravity(OutProposedMove.LinearVelocity, Ctx.Tuning, DeltaTime);
+		}
+		else
+		{
+			// Lost the floor but not walking off yet (FG.Walk.LostFloorTicks) - that only holds
+			// the mode, the mover falls the same as it would in Air.
+			if(Ctx.StartSyncState.FloorlessTicks > 0)
+			{
+				FG::Kinematics::ApplyGravity(OutProposedMove.LinearVelocity, Ctx.Tuning, DeltaTime);
+			}
+		}
+
+		if constexpr (Policy::bFollowSurface)
+		{
+			if(Ctx.LastFloor && Ctx.LastFloor->bBlockingHit)
+			{
+				FG::Kinematics::ClipToSurface(OutProposedMove.LinearVelocity, Ctx.LastFloor->HitResult.ImpactNormal);
+			}
+		}
+	}
+
+	template<typename Policy, typename ModeType>
+	FORCEINLINE void SimulationTick(ModeType& Mode, const FSimulationTickParams& Params, FMoverTickEndData& OutputState)
+	{
+		const FFGMovementContext Ctx(Mode, Params);
+		USceneComponent* UpdatedComponent = Ctx.UpdatedComponent;
+		UPrimitiveComponent* UpdatedPrimitive = Ctx.UpdatedPrimitive;
+		UFGMoverComponent& MoverComp = Ctx.MoverComp;
+		const FProposedMove& ProposedMove = Params.ProposedMove;
+
+		FFGMoverSyncState& OutputSyncState = OutputState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FFGMoverSyncState>();
+
+		FG::FScopedSimulateCost SimulateCost(Ctx.CostStats, OutputSyncState, Policy::ModeId, MoverComp.GetOwner());
+		MoverComp.NotifySimulationTick(Params.TimeStep);
+
+		const float DeltaSeconds = Params.TimeStep.StepMs * 0.001f;
+		Ctx.CostStats.SimSeconds += DeltaSeconds;
+		OutputSyncState.FloorlessTicks = 0;
+		OutputSyncState.IdleTicks = 0;
+		OutputSyncState.bResting = false;
+
+		// Instantaneous movement changes that are executed and we exit before consuming any time
+		if (ProposedMove.bHasTargetLocation && FG::AttemptTeleport(Ctx, ProposedMove.TargetLocation, UpdatedComponent->GetComponentRotation(), OutputState))
+		{
+			MoverComp.GetFloorCache().Invalidate();
+			MoverComp.GetBallisticArc().Invalidate();
+			MoverComp.GetFlightRecorder().Record(Params.TimeStep, Policy::ModeId, OutputSyncState, &Ctx.Input, nullptr, EFGTransitionReason::Teleport);
+			OutputState.MovementEndState.RemainingMs = Params.TimeStep.StepMs; 	// Give back all the time
+			return;
+		}
+
+		// Idle ticks to count on from, the start state's unless this tick wakes the mover.
+		uint8 StartIdleTicks = Ctx.StartSyncState.IdleTicks;
+
+		if constexpr (Policy::bCanRest)
+		{
+			FFGRestState& RestState = MoverComp.GetRestState();
+			if(Ctx.StartSyncState.bResting)
+			{
+				if(RestState.CanStayAtRest(Ctx.Input, ProposedMove))
+				{
+					// Nothing wants us to move - hold where we are without touching the floor or collision.
+					OutputSyncState.SetTransforms_WorldSpace(UpdatedComponent->GetComponentLocation(),
+						UpdatedComponent->GetComponentRotation(),
+						FVector::ZeroVector,
+						nullptr); // no movement base
+
+					OutputSyncState.MoveDirectionIntent = FVector::ZeroVector;
+					OutputSyncState.bResting = true;
+					OutputSyncState.Quantize();
+					UpdatedComponent->ComponentVelocity = FVector::ZeroVector;
+
+					MoverComp.GetFlightRecorder().Record(Params.TimeStep, Policy::ModeId, OutputSyncState, &Ctx.Input, Ctx.LastFloor, EFGTransitionReason::None);
+					FG::Trace::Count(FG::Trace::FrameCounters.RestTicks);
+					return;
+				}
+
+				StartIdleTicks = 0;
+			}
+		}
+
+		if constexpr (Policy::bBallistic)
+		{
+			if(TryBallisticStep<Policy>(Ctx, Params, OutputSyncState))
+			{
+				return;
+			}
+		}
+
+		EFGTransitionReason TransitionReason = EFGTransitionReason::None;
+
+		Policy::PreMove(Mode, Ctx, OutputState, TransitionReason);
+
+		FMovementRecord MoveRecord;
+		MoveRecord.SetDeltaSeconds(DeltaSeconds);
+
+		UMoverBlackboard* SimBlackboard = MoverComp.GetSimBlackboard_Mutable();
+		SimBlackboard->Invalidate(CommonBlackboard::LastFloorResult); // Flush last floor result.
+
+		// Reuses the last floor while we're sliding along it, otherwise sweeps for it again.
+		const FFloorCheckResult& NewFloor = MoverComp.GetFloorCache().FindFloor(Ctx.CostStats, UpdatedComponent, UpdatedPrimitive,
+			FloorSweepDist, MaxWalkSlopeCosine, UpdatedPrimitive->GetComponentLocation(), Params.TimeStep.ServerFrame, Params.TimeStep.BaseSimTimeMs,
+			MoverComp.GetOwnerRole() != ROLE_Authority, MoverComp.GetMovementFrame());
+
+		SimBlackboard->Set(CommonBlackboard::LastFloorResult, NewFloor);
+
+		OutputSyncState.MoveDirectionIntent = (ProposedMove.bHasDirIntent ? ProposedMove.DirectionIntent : FVector::ZeroVector);
+
+		// Use the orientation intent directly. If no intent is provided, use last frame's orientation. Note that we are assuming rotation changes can't fail. 
+		const FRotator StartingOrient = Ctx.StartSyncState.GetOrientation_WorldSpace();
+		FRotator TargetOrient = StartingOrient;
+
+		bool bIsOrientationChanging = false;
+
+		// Apply orientation changes (if any)
+		if (!ProposedMove.AngularVelocity.IsZero())
+		{
+			TargetOrient += (ProposedMove.AngularVelocity * DeltaSeconds);
+			bIsOrientationChanging = (TargetOrient != StartingOrient);
+		}
+
+		FHitResult Hit(1.f);
+		FMoveStep Step { NewFloor, ProposedMove.LinearVelocity * DeltaSeconds, TargetOrient.Quaternion(), Hit, MoveRecord, 0 };
+
+		if (!Step.MoveDelta.IsNearlyZero() || bIsOrientationChanging)
+		{
+			FG::TrySafeMoveUpdatedComponent(Ctx.CostStats, UpdatedComponent, UpdatedPrimitive, Step.MoveDelta, Step.OrientQuat, true, Hit, ETeleportType::None, MoveRecord);
+		}
+
+		Policy::PostMove(Mode, Ctx, Step, OutputState, TransitionReason);
+
+		// Name lookups only when we actually change mode.
+		const FName& NextModeName = OutputState.MovementEndState.NextModeName;
+		const EFGModeId EndModeId = NextModeName.IsNone() ? Policy::ModeId : FG::Modes::ToId(NextModeName);
+		FG::CaptureFinalState(Ctx, MoveRecord, OutputSyncState);
+		OutputSyncState.FloorlessTicks = Step.FloorlessTicks;
+
+		if constexpr (Policy::bCanRest)
+		{
+			const bool bIdle = EndModeId == Policy::ModeId
+				&& !Ctx.Input.HasMoveIntent()
+				&& ProposedMove.AngularVelocity.IsZero()
+				&& OutputSyncState.GetVelocity_WorldSpace().SizeSquared() < FMath::Square(FG::CVars::RestVelocity);
+
+			MoverComp.GetRestState().Update(bIdle, NewFloor, StartIdleTicks, OutputSyncState);
+		}
+
+		MoverComp.GetFlightRecorder().Record(Params.TimeStep, Policy::ModeId, OutputSyncState, &Ctx.Input, &NewFloor, TransitionReason);
+
+		if(TransitionReason != EFGTransitionReason::None)
+		{
+			FG::Trace::Count(FG::Trace::FrameCounters.ModeTransitions);
+		}
+
+		if((Policy::ModeId == EFGModeId::Walk && EndModeId == EFGModeId::Air) || (Policy::ModeId == EFGModeId::Air && EndModeId == EFGModeId::Walk))
+		{
+			++Ctx.CostStats.NumWalkAirTransitions;
+			FG::Trace::Count(FG::Trace::FrameCounters.WalkAirTransitions);
+		}
+	}
+}
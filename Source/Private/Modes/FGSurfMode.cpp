@@ -0,0 +1,109 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Modes/FGSurfMode.h"
+#include "Modes/FGModeTick.h"
+
+#include "FGMovementCVars.h"
+#include "Core/FGDataModel.h"
+#include "Core/FGMovementUtils.h"
+#include "Core/FGMoverComponent.h"
+#include "FGMovementDefines.h"
+#include "FGMovementTrace.h"
+
+#include "MoveLibrary/FloorQueryUtils.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FGSurfMode)
+
+namespace FG::Modes
+{
+	/** Surfing - air constants and gravity, velocity kept on the ramp, leaves at the ramp's edge or once it flattens out. */
+	struct FSurfPolicy
+	{
+		static constexpr EFGModeId		ModeId			= EFGModeId::Surf;
+		static constexpr EFGMoveSurface	Surface			= EFGMoveSurface::Air;
+		static constexpr bool			bApplyDamping	= false;
+		static constexpr bool			bApplyGravity	= true;
+		static constexpr bool			bCanRest		= false;
+		static constexpr bool			bCanJump		= false;
+		static constexpr bool			bBallistic		= false;
+		static constexpr bool			bFollowSurface	= true;
+
+		static FORCEINLINE FVector GetAccelerationDirection(const FFGMovementContext& Ctx, const FVector& MoveInputWS)
+		{
+			return MoveInputWS;
+		}
+
+		static FORCEINLINE float GetDesiredSpeed(const FFGMovementContext& Ctx)
+		{
+			return Ctx.Tuning.AirSpeed;
+		}
+
+		static FORCEINLINE void PreMove(UFGSurfMode& Mode, const FFGMovementContext& Ctx, FMoverTickEndData& OutputState, EFGTransitionReason& OutReason)
+		{
+		}
+
+		static FORCEINLINE void PostMove(UFGSurfMode& Mode, const FFGMovementContext& Ctx, FG::ModeTick::FMoveStep& Step, FMoverTickEndData& OutputState, EFGTransitionReason& OutReason)
+		{
+			if(Step.Hit.bBlockingHit)
+			{
+				FG::SlideAlongSurfaces(
+					Ctx.CostStats,
+					Ctx.UpdatedComponent,
+					Ctx.UpdatedPrimitive,
+					Step.MoveDelta,
+					Step.OrientQuat,
+					Step.Hit,
+					Step.MoveRecord);
+			}
+
+			// Only walk off once the floor is clearly walkable, so we don't thrash around the slope limit.
+			if(Step.Floor.bWalkableFloor && Step.Floor.HitResult.ImpactNormal.Z >= FG::ModeTick::MaxWalkSlopeCosine + FG::CVars::SurfWalkHysteresis)
+			{
+				OutputState.MovementEndState.NextModeName = FG::Modes::Walk;
+				OutReason = EFGTransitionReason::Landed;
+			}
+			else if(!FG::ModeTick::IsSurfable(Step.Floor) && !Step.Floor.bWalkableFloor)
+			{
+				OutputState.MovementEndState.NextModeName = FG::Modes::Air;
+				OutReason = EFGTransitionReason::LostFloor;
+			}
+		}
+	};
+}
+
+/**
+ * Generate a single substep of movement for the mode - air control and gravity, with the
+ * result projected onto the ramp we're surfing on.
+ * 
+ * @param StartState - Inputs, sync state, and other data from the start of the tick.
+ * @param TimeStep - The time step for this substep.
+ * @param OutProposedMove - The proposed move to provide to the next tick that runs.
+ */
+void UFGSurfMode::OnGenerateMove(const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, FProposedMove& OutProposedMove) const
+{
+	FG_SCOPE_CYCLE(UFGSurfMode::OnGenerateMove);
+	CSV_SCOPED_TIMING_STAT(FGMovement, GenerateMove);
+
+	FG::ModeTick::GenerateMove<FG::Modes::FSurfPolicy>(*this, StartState, TimeStep, OutProposedMove);
+}
+
+/**
+ * Actual network prediction plugin tick - Evolution of the sync state.
+ * 
+ * @param Params - The parameters for the tick.
+ * @param OutputState - The final state of the mover after the tick.
+ */
+void UFGSurfMode::OnSimulationTick(const FSimulationTickParams& Params, FMoverTickEndData& OutputState)
+{
+	FG_SCOPE_CYCLE(UFGSurfMode::OnSimulationTick);
+	CSV_SCOPED_TIMING_STAT(FGMovement, SimulationTick);
+
+	FG::ModeTick::SimulationTick<FG::Modes::FSurfPolicy>(*this, Params, OutputState);
+}
@@ -8,6 +8,7 @@
 // SOFTWARE.
 
 #include "Modes/FGWalkMode.h"
+#include "Modes/FGModeTick.h"
 #include "Core/FGMovementUtils.h"
 #include "Core/FGDataModel.h"
 #include "LayeredMoves/FGLayeredMove_Crouch.h"
@@ -15,8 +16,8 @@
 #include "FGMovementCVars.h"
 #include "Core/FGMoverComponent.h"
 #include "FGMovementDefines.h"
+#include "FGMovementTrace.h"
 
-#include "DefaultMovementSet/LayeredMoves/BasicLayeredMoves.h"
 #include "MoveLibrary/MovementUtils.h"
 #include "MoveLibrary/FloorQueryUtils.h"
 #include "MoverComponent.h"
@@ -25,6 +26,126 @@
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FGWalkMode)
 
+namespace FG::Modes
+{
+	/** Walking - ground constants, move input follows the floor, falls when it loses the floor. */
+	struct FGroundPolicy
+	{
+		static constexpr EFGModeId		ModeId			= EFGModeId::Walk;
+		static constexpr EFGMoveSurface	Surface			= EFGMoveSurface::Ground;
+		static constexpr bool			bApplyDamping	= true;
+		static constexpr bool			bApplyGravity	= false;
+		static constexpr bool			bCanRest		= true;
+		static constexpr bool			bCanJump		= true;
+		static constexpr bool			bFollowSurface	= false;
+		static constexpr bool			bBallistic		= false;
+
+		// Gap left between us and the floor we snap onto.
+		static constexpr float			SnapSkin		= 0.1f;
+
+		static FORCEINLINE FVector GetAccelerationDirection(const FFGMovementContext& Ctx, const FVector& MoveInputWS)
+		{
+			FVector ProjectedMove = Ctx.LastFloor ? FVector::VectorPlaneProject(MoveInputWS, Ctx.LastFloor->HitResult.ImpactNormal) : MoveInputWS;
+			ProjectedMove.Normalize();
+			return ProjectedMove;
+		}
+
+		static FORCEINLINE float GetDesiredSpeed(const FFGMovementContext& Ctx)
+		{
+			return Ctx.Tuning.GroundSpeed * (Ctx.Input.bIsSprintPressed ? Ctx.Tuning.SprintSpeedMult : 1.0f);
+		}
+
+		static FORCEINLINE void PreMove(UFGWalkMode& Mode, const FFGMovementContext& Ctx, FMoverTickEndData& OutputState, EFGTransitionReason& OutReason)
+		{
+			if(Mode.TryJump(Ctx, OutputState))
+			{
+				OutputState.MovementEndState.NextModeName = FG::Modes::Air;
+				OutReason = EFGTransitionReason::Jump;
+			}
+		}
+
+		/**
+		 * Look further down than the regular floor check for a walkable floor, and move onto it
+		 * if there is one - keeps us walking down slopes and small steps instead of falling for a tick.
+		 */
+		static bool TrySnapToFloor(const FFGMovementContext& Ctx, FG::ModeTick::FMoveStep& Step)
+		{
+			// Moving up means we're being launched, not walking off something.
+			if(FG::CVars::WalkSnapDistance <= 0.0f || Step.MoveDelta.Z > UE_KINDA_SMALL_NUMBER)
+			{
+				return false;
+			}
+
+			FFloorCheckResult SnapFloor;
+			FG::FindFloor(Ctx.CostStats, Ctx.UpdatedComponent, Ctx.UpdatedPrimitive,
+				FG::CVars::WalkSnapDistance, FG::ModeTick::MaxWalkSlopeCosine, Ctx.UpdatedPrimitive->GetComponentLocation(), SnapFloor);
+
+			if(!SnapFloor.bWalkableFloor)
+			{
+				return false;
+			}
+
+			// The snap isn't part of our velocity.
+			FHitResult SnapHit(1.f);
+			Step.MoveRecord.LockRelevancy(false);
+			FG::TrySafeMoveUpdatedComponent(Ctx.CostStats, Ctx.UpdatedComponent, Ctx.UpdatedPrimitive,
+				-FVector::UpVector * FMath::Max(SnapFloor.FloorDist - SnapSkin, 0.0f), Step.OrientQuat, true, SnapHit, ETeleportType::None, Step.MoveRecord);
+			Step.MoveRecord.UnlockRelevancy();
+			return true;
+		}
+
+		static FORCEINLINE void PostMove(UFGWalkMode& Mode, const FFGMovementContext& Ctx, FG::ModeTick::FMoveStep& Step, FMoverTickEndData& OutputState, EFGTransitionReason& OutReason)
+		{
+			if (Step.Floor.bWalkableFloor && Ctx.UpdatedPrimitive)
+			{
+				// Clipping the move against the walls also clamps our speed along them by their angle.
+				FG::SlideAlongSurfaces(
+					Ctx.CostStats,
+					Ctx.UpdatedComponent,
+					Ctx.UpdatedPrimitive,
+					Step.MoveDelta,
+					Step.OrientQuat,
+					Step.Hit,
+					Step.MoveRecord);
+			}
+			else if(FG::ModeTick::IsSurfable(Step.Floor))
+			{
+				OutputState.MovementEndState.NextModeName = FG::Modes::Surf;
+				OutReason = EFGTransitionReason::Surf;
+			}
+			else if(Ctx.UpdatedPrimitive && TrySnapToFloor(Ctx, Step))
+			{
+				// Still walking.
+			}
+			else
+			{
+				// Nothing underneath - move like Air does, walls included. See GenerateMove for the gravity.
+				if(Step.Hit.bBlockingHit && Ctx.UpdatedPrimitive)
+				{
+					FG::SlideAlongSurfaces(
+						Ctx.CostStats,
+						Ctx.UpdatedComponent,
+						Ctx.UpdatedPrimitive,
+						Step.MoveDelta,
+						Step.OrientQuat,
+						Step.Hit,
+						Step.MoveRecord);
+				}
+
+				// Only change the mode once the floor has been gone for a few ticks in a row.
+				Step.FloorlessTicks = static_cast<uint8>(Ctx.StartSyncState.FloorlessTicks + 1);
+
+				if(Step.FloorlessTicks >= FMath::Clamp(FG::CVars::WalkLostFloorTicks, 1, 3))
+				{
+					Step.FloorlessTicks = 0;
+					OutputState.MovementEndState.NextModeName = FG::Modes::Air;
+					OutReason = EFGTransitionReason::LostFloor;
+				}
+			}
+		}
+	};
+}
+
 UFGWalkMode::UFGWalkMode()
 {
 	Transitions.Add(CreateDefaultSubobject<UFGCrouchCheck>(TEXT("DuckCheck")));
@@ -42,39 +163,10 @@ UFGWalkMode::UFGWalkMode()
  */
 void UFGWalkMode::OnGenerateMove(const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, FProposedMove& OutProposedMove) const
 {
-	const FFGMoverInputCmd* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FFGMoverInputCmd>();
-	const FMoverDefaultSyncState* StartingSyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
-	check(StartingSyncState);
-
-	OutProposedMove.LinearVelocity = StartingSyncState->GetVelocity_WorldSpace();
-	const float DeltaTime = TimeStep.StepMs * 0.001f;
-	
-	UFGMovementUtils::ApplyDamping(CastChecked<UFGMoverComponent>(GetMoverComponent()), OutProposedMove, DeltaTime);
-
-	constexpr float TurningRateLimit = 5000.0f;
-	
-	// @TODO: This is going to break if the player isn't Z up. Works for now.
-    OutProposedMove.AngularVelocity = UMovementUtils::ComputeAngularVelocity(
-    	StartingSyncState->GetOrientation_WorldSpace(),
-    	CharacterInputs->GetOrientationIntentDir_WorldSpace().ToOrientationRotator(),
-    	DeltaTime,
-    	TurningRateLimit);
-    
-    UE_LOGFMT(LogMover, Display, "Angular Velocity: {AngVel}", *OutProposedMove.AngularVelocity.ToString());
-    
-    OutProposedMove.DirectionIntent = CharacterInputs->GetOrientationIntentDir_WorldSpace();
-    	
-	FFloorCheckResult FloorResult;
-	GetMoverComponent()->GetSimBlackboard()->TryGet(CommonBlackboard::LastFloorResult, FloorResult);
-
-	FVector MoveInputWS = OutProposedMove.DirectionIntent.ToOrientationRotator().RotateVector(CharacterInputs->GetMoveInput());
-
-	FVector ProjectedMove = FVector::VectorPlaneProject(MoveInputWS, FloorResult.HitResult.ImpactNormal);
-	ProjectedMove.Normalize();
-
-	UFGMovementUtils::ApplyAcceleration(CastChecked<UFGMoverComponent>(GetMoverComponent()), OutProposedMove, DeltaTime, ProjectedMove, FG::CVars::GroundSpeed);
-
-    UE_LOGFMT(LogMover, Display, "Linear Velocity: {LinVel}", *OutProposedMove.LinearVelocity.ToString());
+	FG_SCOPE_CYCLE(UFGWalkMode::OnGenerateMove);
+	CSV_SCOPED_TIMING_STAT(FGMovement, GenerateMove);
+
+	FG::ModeTick::GenerateMove<FG::Modes::FGroundPolicy>(*this, StartState, TimeStep, OutProposedMove);
 }
 
 /**
@@ -88,109 +180,20 @@ void UFGWalkMode::OnGenerateMove(const FMoverTickStartData& StartState, const FM
  */
 void UFGWalkMode::OnSimulationTick(const FSimulationTickParams& Params, FMoverTickEndData& OutputState)
 {
-	const FMoverTickStartData& StartState = Params.StartState;
-	USceneComponent* UpdatedComponent = Params.UpdatedComponent;
-	UPrimitiveComponent* UpdatedPrimitive = Params.UpdatedPrimitive;
-	FProposedMove ProposedMove = Params.ProposedMove;
-
-	const FFGMoverInputCmd* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FFGMoverInputCmd>();
-	const FMoverDefaultSyncState* StartingSyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
-	check(StartingSyncState);
-
-	FMoverDefaultSyncState& OutputSyncState = OutputState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FMoverDefaultSyncState>();
-
-	const float DeltaSeconds = Params.TimeStep.StepMs * 0.001f;
-
-	// Instantaneous movement changes that are executed and we exit before consuming any time
-	if (ProposedMove.bHasTargetLocation && FG::AttemptTeleport(UpdatedComponent, ProposedMove.TargetLocation, UpdatedComponent->GetComponentRotation(), *StartingSyncState, OutputState))
-	{
-		OutputState.MovementEndState.RemainingMs = Params.TimeStep.StepMs; 	// Give back all the time
-		return;
-	}
-
-	if(TryJump(CharacterInputs, OutputState))
-	{
-		OutputState.MovementEndState.NextModeName = FG::Modes::Air;
-	}
-
-	FMovementRecord MoveRecord;
-	MoveRecord.SetDeltaSeconds(DeltaSeconds);
-
-	UMoverBlackboard* SimBlackboard = GetBlackboard_Mutable();
-	SimBlackboard->Invalidate(CommonBlackboard::LastFloorResult); // Flush last floor result.
-
-	constexpr float FloorSweepDist = 1.0f;
-	constexpr float MaxWalkSlopeCosine = 0.71f;
-
-	FFloorCheckResult NewFloor;
-	
-	// If we don't have cached floor information, we need to search for it again
-	UFloorQueryUtils::FindFloor(UpdatedComponent, UpdatedPrimitive, FloorSweepDist,
-		MaxWalkSlopeCosine, UpdatedPrimitive->GetComponentLocation(), NewFloor);
-
-	SimBlackboard->Set(CommonBlackboard::LastFloorResult, NewFloor);
-
-	OutputSyncState.MoveDirectionIntent = (ProposedMove.bHasDirIntent ? ProposedMove.DirectionIntent : FVector::ZeroVector);
-
-	// Use the orientation intent directly. If no intent is provided, use last frame's orientation. Note that we are assuming rotation changes can't fail. 
-	const FRotator StartingOrient = StartingSyncState->GetOrientation_WorldSpace();
-	FRotator TargetOrient = StartingOrient;
-
-	bool bIsOrientationChanging = false;
-
-	// Apply orientation changes (if any)
-	if (!ProposedMove.AngularVelocity.IsZero())
-	{
-		TargetOrient += (ProposedMove.AngularVelocity * DeltaSeconds);
-		bIsOrientationChanging = (TargetOrient != StartingOrient);
-	}
-	
-	FVector MoveDelta = ProposedMove.LinearVelocity * DeltaSeconds;
-	const FQuat OrientQuat = TargetOrient.Quaternion();
-	FHitResult Hit(1.f);
-
-	if (!MoveDelta.IsNearlyZero() || bIsOrientationChanging)
-	{
-		UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, MoveDelta, OrientQuat, true, Hit, ETeleportType::None, MoveRecord);
-	}
-
-	if (NewFloor.bWalkableFloor && UpdatedPrimitive)
-	{
-		// @TODO: Stinky forward port from NPP implementation - Fix me.
-		// In the NPP implementation we did a really dirty hack and basically just bodged the
-		// slide vector to the expected travel distance. This means when you run into a wall
-		// your movement speed isn't clamped depending on the angle of the wall.
-		// However we can do it way better now, although it may mean not using this util.
-		UMovementUtils::TryMoveToSlideAlongSurface(
-			UpdatedComponent,
-			UpdatedPrimitive,
-			GetMoverComponent(),
-			MoveDelta,
-			1.f - Hit.Time,
-			OrientQuat,
-			Hit.Normal,
-			Hit,
-			false,
-			MoveRecord);
-	}
-	else
-	{
-		OutputState.MovementEndState.NextModeName = FG::Modes::Air;
-	}
+	FG_SCOPE_CYCLE(UFGWalkMode::OnSimulationTick);
+	CSV_SCOPED_TIMING_STAT(FGMovement, SimulationTick);
 
-	FG::CaptureFinalState(UpdatedComponent, MoveRecord, *StartingSyncState, OutputSyncState, DeltaSeconds);
+	FG::ModeTick::SimulationTick<FG::Modes::FGroundPolicy>(*this, Params, OutputState);
 }
 
-bool UFGWalkMode::TryJump(const FFGMoverInputCmd* InputCmd, FMoverTickEndData& OutputState)
+bool UFGWalkMode::TryJump(const FFGMovementContext& Ctx, FMoverTickEndData& OutputState)
 {
-	if(!InputCmd->bIsJumpPressed)
+	if(!Ctx.Input.bIsJumpPressed)
 	{
 		return false;
 	}
 
-	TSharedPtr<FLayeredMove_JumpImpulse> JumpMove = MakeShared<FLayeredMove_JumpImpulse>();
-	JumpMove->UpwardsSpeed = FG::CVars::JumpForce;
-	OutputState.SyncState.LayeredMoves.QueueLayeredMove(JumpMove);
+	// The jump velocity is already in the proposed move, see FGroundPolicy::bCanJump.
 	OutputState.MovementEndState.NextModeName = FG::Modes::Air;
 
 	return true;
@@ -0,0 +1,401 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Core/FGInputProducer.h"
+#include "Core/FGMoverComponent.h"
+#include "Core/FGPawn.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+/**
+ * Golden movement tests. Every scenario builds a level out of boxes, drives one FG pawn
+ * through a fixed input script at a fixed frame rate, and checks the resulting trajectory
+ * hash and tick count against Content/Tests/FGMovementGolden.txt in the plugin, along with
+ * the scenario's cost budgets and a sanity check of where the pawn ended up.
+ *
+ * Each line of the golden file is "<Scenario> <Ticks> <Hash> <MaxAvgTickUs> <MaxAvgSweeps>",
+ * '-' for a tick count and hash that haven't been recorded yet, which only warns. Movement changes that are
+ * meant to change trajectories are recorded with FG.Tests.RecordGolden 1, budgets are edited
+ * by hand.
+ */
+namespace FG::Tests
+{
+	static bool bRecordGolden = false;
+	static FAutoConsoleVariableRef CVarRecordGolden(
+		TEXT("FG.Tests.RecordGolden"),
+		bRecordGolden,
+		TEXT("Write the tick counts and hashes of the FGMovement.Golden tests to the golden file instead of checking them (0/1)."),
+		ECVF_Default
+	);
+
+	static constexpr float FrameSeconds = 1.0f / 60.0f;
+
+	// Height of the capsule center above the floor it stands on, plus a little to drop in from.
+	static constexpr double SpawnHeight = 100.0;
+
+	struct FGoldenEntry
+	{
+		FString	Ticks;
+		FString	Hash;
+		double	MaxAvgTickUs = 0.0;
+		double	MaxAvgSweeps = 0.0;
+	};
+
+	static FString GetGoldenPath()
+	{
+		const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("FGMovement"));
+		return Plugin.IsValid() ? Plugin->GetContentDir() / TEXT("Tests") / TEXT("FGMovementGolden.txt") : FString();
+	}
+
+	/** Game world made of boxes, ticked by hand. */
+	class FTestWorld
+	{
+	public:
+
+		FTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("FGMovementTestWorld"));
+
+			FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+			Context.SetCurrentWorld(World);
+
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+		}
+
+		~FTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		/** Add a blocking box, the only kind of floor the floor cache reuses. */
+		void AddBox(const FVector& Location, const FRotator& Rotation, const FVector& Extent)
+		{
+			AActor* Actor = World->SpawnActor<AActor>();
+
+			UBoxComponent* Box = NewObject<UBoxComponent>(Actor);
+			Box->SetBoxExtent(Extent, false);
+			Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+			Actor->SetRootComponent(Box);
+			Box->SetWorldLocationAndRotation(Location, Rotation);
+			Box->RegisterComponent();
+		}
+
+		/** Spawn a pawn at a location, driven by a script. */
+		AFGPawn* SpawnPawn(const FVector& Location, const TArray<FFGScriptedInputStep>& Steps)
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+			AFGPawn* Pawn = World->SpawnActor<AFGPawn>(AFGPawn::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+			if(Pawn)
+			{
+				UFGScriptedInputProducer* Producer = NewObject<UFGScriptedInputProducer>(Pawn);
+				Producer->Steps = Steps;
+				Pawn->SetInputProducer(Producer);
+			}
+			return Pawn;
+		}
+
+		void Tick()
+		{
+			World->Tick(LEVELTICK_All, FrameSeconds);
+		}
+
+		UWorld* World = nullptr;
+	};
+
+	/** Where the pawn went over a run, for the sanity checks. */
+	struct FRunResult
+	{
+		FVector		Start		= FVector::ZeroVector;
+		FVector		End			= FVector::ZeroVector;
+		double		MaxZ		= -UE_DOUBLE_BIG_NUMBER;
+		bool		bWasAirborne = false;
+		EFGModeId	EndMode		= EFGModeId::None;
+	};
+
+	struct FScenario
+	{
+		const TCHAR*					Name;
+		TFunction<void(FTestWorld&)>	BuildLevel;
+		FVector							Start;
+		TArray<FFGScriptedInputStep>	Steps;
+
+		// @return Empty if the run looks right, what's wrong with it otherwise.
+		TFunction<FString(const FRunResult&)> Check;
+	};
+
+	static FFGScriptedInputStep Step(int32 DurationMs, const FVector& MoveInput, float Yaw = 0.0f, bool bJump = false, bool bCrouch = false, bool bSprint = false)
+	{
+		FFGScriptedInputStep Out;
+		Out.DurationMs = DurationMs;
+		Out.MoveInput = MoveInput;
+		Out.Yaw = Yaw;
+		Out.bJump = bJump;
+		Out.bCrouch = bCrouch;
+		Out.bSprint = bSprint;
+		return Out;
+	}
+
+	static void BuildFlatFloor(FTestWorld& TestWorld)
+	{
+		TestWorld.AddBox(FVector(0.0, 0.0, -50.0), FRotator::ZeroRotator, FVector(10000.0, 10000.0, 50.0));
+	}
+
+	static const TArray<FScenario>& GetScenarios()
+	{
+		static const TArray<FScenario> Scenarios =
+		{
+			{
+				TEXT("Run"),
+				&BuildFlatFloor,
+				FVector(0.0, 0.0, SpawnHeight),
+				{ Step(500, FVector::ZeroVector), Step(2000, FVector::ForwardVector, 0.0f, false, false, true), Step(1000, FVector::ZeroVector) },
+				[](const FRunResult& Run)
+				{
+					return Run.End.X - Run.Start.X > 1000.0 && Run.EndMode == EFGModeId::Walk ? FString() : FString(TEXT("didn't run forward and stop on the floor"));
+				}
+			},
+			{
+				TEXT("Strafe"),
+				&BuildFlatFloor,
+				FVector(0.0, 0.0, SpawnHeight),
+				{ Step(500, FVector::ZeroVector, 45.0f), Step(1000, FVector::RightVector, 45.0f), Step(1000, -FVector::RightVector, 45.0f), Step(1500, FVector::RightVector, 45.0f) },
+				[](const FRunResult& Run)
+				{
+					// Strafing right at 45 degrees of yaw heads along -X +Y.
+					const FVector Delta = Run.End - Run.Start;
+					return Delta.Y > 200.0 && Delta.X < -200.0 ? FString() : FString(TEXT("didn't strafe off to the right"));
+				}
+			},
+			{
+				TEXT("Jump"),
+				&BuildFlatFloor,
+				FVector(0.0, 0.0, SpawnHeight),
+				{ Step(500, FVector::ZeroVector), Step(1500, FVector::ForwardVector, 0.0f, true), Step(1500, FVector::ZeroVector) },
+				[](const FRunResult& Run)
+				{
+					// Back on the floor at the end, so the end height is the floor height.
+					return Run.MaxZ - Run.End.Z > 30.0 && Run.EndMode == EFGModeId::Walk ? FString() : FString(TEXT("didn't jump and land again"));
+				}
+			},
+			{
+				TEXT("Crouch"),
+				&BuildFlatFloor,
+				FVector(0.0, 0.0, SpawnHeight),
+				{ Step(500, FVector::ZeroVector), Step(1000, FVector::ForwardVector, 0.0f, false, true), Step(500, FVector::ForwardVector), Step(1000, FVector::ZeroVector, 0.0f, false, true) },
+				[](const FRunResult& Run)
+				{
+					return Run.End.X - Run.Start.X > 300.0 && Run.EndMode == EFGModeId::Walk ? FString() : FString(TEXT("didn't crouch walk forward"));
+				}
+			},
+			{
+				TEXT("SlopeLanding"),
+				[](FTestWorld& TestWorld)
+				{
+					// A 25 degree ramp rising towards +X, walkable (FG::ModeTick::MaxWalkSlopeCosine).
+					BuildFlatFloor(TestWorld);
+					TestWorld.AddBox(FVector(0.0, 0.0, 0.0), FRotator(25.0, 0.0, 0.0), FVector(1000.0, 500.0, 50.0));
+				},
+				FVector(0.0, 0.0, 600.0),
+				{ Step(2000, FVector::ZeroVector), Step(1000, -FVector::ForwardVector), Step(1000, FVector::ZeroVector) },
+				[](const FRunResult& Run)
+				{
+					return Run.bWasAirborne && Run.End.X < Run.Start.X && Run.EndMode == EFGModeId::Walk ? FString() : FString(TEXT("didn't land on the ramp and walk down it"));
+				}
+			},
+			{
+				TEXT("WallSlide"),
+				[](FTestWorld& TestWorld)
+				{
+					// A wall along X, 200 units to the right of the start.
+					BuildFlatFloor(TestWorld);
+					TestWorld.AddBox(FVector(0.0, 250.0, 200.0), FRotator::ZeroRotator, FVector(5000.0, 50.0, 200.0));
+				},
+				FVector(0.0, 0.0, SpawnHeight),
+				{ Step(500, FVector::ZeroVector, 30.0f), Step(2500, FVector::ForwardVector, 30.0f, false, false, true), Step(500, FVector::ZeroVector, 30.0f) },
+				[](const FRunResult& Run)
+				{
+					// Heading 30 degrees into the wall, the pawn has to slide along it rather than through it.
+					return Run.End.X - Run.Start.X > 1000.0 && Run.End.Y < 200.0 ? FString() : FString(TEXT("didn't slide along the wall"));
+				}
+			},
+		};
+		return Scenarios;
+	}
+
+	static bool LoadGolden(const FString& Path, TMap<FString, FGoldenEntry>& OutEntries, TArray<FString>& OutLines)
+	{
+		if(!FFileHelper::LoadFileToStringArray(OutLines, *Path))
+		{
+			return false;
+		}
+
+		for(const FString& Line : OutLines)
+		{
+			TArray<FString> Fields;
+			if(Line.StartsWith(TEXT("#")) || Line.ParseIntoArrayWS(Fields) < 5)
+			{
+				continue;
+			}
+
+			FGoldenEntry& Entry = OutEntries.Add(Fields[0]);
+			Entry.Ticks = Fields[1];
+			Entry.Hash = Fields[2];
+			Entry.MaxAvgTickUs = FCString::Atod(*Fields[3]);
+			Entry.MaxAvgSweeps = FCString::Atod(*Fields[4]);
+		}
+		return true;
+	}
+
+	/** Rewrite a scenario's line of the golden file with new ticks and hash, keeping its budgets. */
+	static bool RecordGolden(const FString& Path, TArray<FString> Lines, const FString& Name, const FGoldenEntry& Entry)
+	{
+		for(FString& Line : Lines)
+		{
+			TArray<FString> Fields;
+			if(!Line.StartsWith(TEXT("#")) && Line.ParseIntoArrayWS(Fields) >= 5 && Fields[0] == Name)
+			{
+				Line = FString::Printf(TEXT("%s %s %s %s %s"), *Name, *Entry.Ticks, *Entry.Hash, *Fields[3], *Fields[4]);
+			}
+		}
+		return FFileHelper::SaveStringArrayToFile(Lines, *Path);
+	}
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FFGMovementGoldenTest, "FGMovement.Golden",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+void FFGMovementGoldenTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for(const FG::Tests::FScenario& Scenario : FG::Tests::GetScenarios())
+	{
+		OutBeautifiedNames.Add(Scenario.Name);
+		OutTestCommands.Add(Scenario.Name);
+	}
+}
+
+bool FFGMovementGoldenTest::RunTest(const FString& Parameters)
+{
+	using namespace FG::Tests;
+
+	const FScenario* Scenario = GetScenarios().FindByPredicate([&Parameters](const FScenario& Candidate) { return Parameters == Candidate.Name; });
+	if(!Scenario)
+	{
+		AddError(FString::Printf(TEXT("Unknown scenario %s"), *Parameters));
+		return false;
+	}
+
+	const FString GoldenPath = GetGoldenPath();
+	TMap<FString, FGoldenEntry> GoldenEntries;
+	TArray<FString> GoldenLines;
+	if(!LoadGolden(GoldenPath, GoldenEntries, GoldenLines))
+	{
+		AddError(FString::Printf(TEXT("Couldn't load the golden file %s"), *GoldenPath));
+		return false;
+	}
+
+	const FGoldenEntry* Golden = GoldenEntries.Find(Scenario->Name);
+	if(!Golden)
+	{
+		AddError(FString::Printf(TEXT("%s has no line in %s"), Scenario->Name, *GoldenPath));
+		return false;
+	}
+
+	FTestWorld TestWorld;
+	Scenario->BuildLevel(TestWorld);
+
+	AFGPawn* Pawn = TestWorld.SpawnPawn(Scenario->Start, Scenario->Steps);
+	if(!TestNotNull(TEXT("Spawned pawn"), Pawn))
+	{
+		return false;
+	}
+
+	UFGMoverComponent* MoverComp = Pawn->GetMoverComponent();
+	MoverComp->GetCostStats().Reset();
+
+	FRunResult Run;
+	Run.Start = Pawn->GetActorLocation();
+
+	const UFGScriptedInputProducer* Producer = CastChecked<UFGScriptedInputProducer>(Pawn->GetInputProducer());
+	const int32 NumFrames = FMath::CeilToInt(Producer->GetDurationMs() * 0.001f / FrameSeconds) + 1;
+
+	for(int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		TestWorld.Tick();
+
+		Run.MaxZ = FMath::Max(Run.MaxZ, Pawn->GetActorLocation().Z);
+		Run.bWasAirborne |= MoverComp->IsAirborne();
+	}
+
+	Run.End = Pawn->GetActorLocation();
+	Run.EndMode = MoverComp->GetModeId();
+
+	const FString Problem = Scenario->Check(Run);
+	if(!Problem.IsEmpty())
+	{
+		AddError(FString::Printf(TEXT("%s %s: went from %s to %s, ended in mode %d"), Scenario->Name, *Problem,
+			*Run.Start.ToString(), *Run.End.ToString(), static_cast<int32>(Run.EndMode)));
+	}
+
+	const FFGMoverCostStats& Stats = MoverComp->GetCostStats();
+	FGoldenEntry Measured = *Golden;
+	Measured.Ticks = FString::Printf(TEXT("%llu"), Stats.NumTicks);
+	Measured.Hash = FString::Printf(TEXT("%08x"), Stats.TrajectoryHash);
+
+	if(bRecordGolden)
+	{
+		if(!RecordGolden(GoldenPath, GoldenLines, Scenario->Name, Measured))
+		{
+			AddError(FString::Printf(TEXT("Couldn't write the golden file %s"), *GoldenPath));
+		}
+		AddInfo(FString::Printf(TEXT("%s recorded: %s ticks, hash %s"), Scenario->Name, *Measured.Ticks, *Measured.Hash));
+	}
+	else if(Golden->Ticks == TEXT("-") || Golden->Hash == TEXT("-"))
+	{
+		// The sanity check and budgets below still apply, only the trajectory isn't pinned down yet.
+		AddWarning(FString::Printf(TEXT("%s has no golden trajectory yet (%s ticks, hash %s), record it with FG.Tests.RecordGolden 1"),
+			Scenario->Name, *Measured.Ticks, *Measured.Hash));
+	}
+	else if(Measured.Ticks != Golden->Ticks || Measured.Hash != Golden->Hash)
+	{
+		AddError(FString::Printf(TEXT("%s diverged (%s ticks, hash %s) from golden (%s ticks, hash %s)"),
+			Scenario->Name, *Measured.Ticks, *Measured.Hash, *Golden->Ticks, *Golden->Hash));
+	}
+
+	// Sweep counts are exact, timings are only meaningful in optimized builds.
+	if(Stats.GetAverageSweeps() > Golden->MaxAvgSweeps)
+	{
+		AddError(FString::Printf(TEXT("%s averaged %.3f sweeps per tick, over its budget of %.3f"), Scenario->Name, Stats.GetAverageSweeps(), Golden->MaxAvgSweeps));
+	}
+
+#if !UE_BUILD_DEBUG
+	if(Stats.GetAverageTickUs() > Golden->MaxAvgTickUs)
+	{
+		AddError(FString::Printf(TEXT("%s averaged %.3fus per tick, over its budget of %.3fus"), Scenario->Name, Stats.GetAverageTickUs(), Golden->MaxAvgTickUs));
+	}
+#endif
+
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -11,14 +11,16 @@
 #include "LayeredMoves/FGLayeredMove_Crouch.h"
 #include "Core/FGDataModel.h"
 #include "FGMovementDefines.h"
+#include "FGMovementTrace.h"
 
 #include "MoverSimulationTypes.h"
 #include "MoverComponent.h"
 
 void UFGCrouchCheck::OnTrigger(const FSimulationTickParams& Params)
 {
-	TSharedPtr<FFGLayeredMove_Crouch> DuckMove = MakeShared<FFGLayeredMove_Crouch>();
+	TSharedPtr<FFGLayeredMove_Crouch> DuckMove = FG::Memory::AcquireShared(CachedCrouchMove);
 	Params.MoverComponent->QueueLayeredMove(DuckMove);
+	FG::Trace::Count(FG::Trace::FrameCounters.LayeredMovesQueued);
 }
 
 FTransitionEvalResult UFGCrouchCheck::OnEvaluate(const FSimulationTickParams& Params) const
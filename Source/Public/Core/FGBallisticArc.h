@@ -0,0 +1,86 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Core/FGKinematics.h"
+
+struct FFGMoverCostStats;
+class UPrimitiveComponent;
+
+/**
+ * Swept clearance of static geometry along the ballistic arc of a single airborne mover with
+ * no air control. The arc from the launch location and velocity is covered by one straight
+ * sweep against static primitives along its chord over FG.Air.BallisticHorizon, with the
+ * mover's shape inflated by the arc's sagitta (how far the parabola can stray from the chord),
+ * the drift of the stepped integration below the exact parabola, and the floor sweep distance.
+ * The swept volume is convex, so any step that starts and ends inside it up to the first hit
+ * can neither hit static geometry nor find a static floor.
+ *
+ * Movable primitives - pawns, other movers, props - can come into the arc after it was cast,
+ * so every step still sweeps against them (SweepDynamic), and only a step clear of both is
+ * taken without the full move's movement and floor sweeps. Such a step is integrated exactly
+ * like the full air move, so as long as static geometry doesn't change under a cast arc the
+ * mover ends up where the full move would have put it. The arc isn't part of the simulation
+ * state, so it isn't used while replaying frames after a correction and is dropped on rollback.
+ */
+struct FGMOVEMENT_API FFGBallisticArc
+{
+	/**
+	 * Cast a new arc, replacing the current one.
+	 *
+	 * @param Stats - Sweep stats of the mover, bumped for the chord sweep.
+	 * @param UpdatedPrimitive - The mover's collision primitive.
+	 * @param Location - Where the arc starts.
+	 * @param Velocity - The velocity at the start of the arc.
+	 * @param GravitySpeed - The gravity the arc falls with.
+	 * @param DeltaTime - Length of the steps the arc will be followed with.
+	 * @param FloorSweepDistance - How close a floor may get before the mode has to look for it.
+	 */
+	void Cast(FFGMoverCostStats& Stats, UPrimitiveComponent* UpdatedPrimitive, const FVector& Location, const FVector& Velocity,
+		float GravitySpeed, float DeltaTime, float FloorSweepDistance);
+
+	/**
+	 * @return Whether a straight step stays inside the swept part of the arc, i.e. can be taken without sweeping.
+	 *
+	 * @param StartLocation - Where the step starts.
+	 * @param EndLocation - Where the step ends.
+	 */
+	bool CanAdvance(const FVector& StartLocation, const FVector& EndLocation) const;
+
+	/**
+	 * Sweep a step against movable primitives only, the part of the world a cast arc can't vouch for.
+	 *
+	 * @param Stats - Sweep stats of the mover, bumped for the sweep.
+	 * @param UpdatedPrimitive - The mover's collision primitive.
+	 * @param StartLocation - Where the step starts.
+	 * @param EndLocation - Where the step ends.
+	 * @param FloorSweepDistance - How close a floor may get before the mode has to look for it.
+	 * @return Whether the step is clear of anything movable, floor distance included.
+	 */
+	static bool SweepDynamic(FFGMoverCostStats& Stats, UPrimitiveComponent* UpdatedPrimitive, const FVector& StartLocation, const FVector& EndLocation,
+		float FloorSweepDistance);
+
+	/** @return Whether casting a new arc is worth it, false for a few steps after a cast that was blocked right away. */
+	bool ShouldCast();
+
+	/** Forget the arc, the next step casts a new one. */
+	void Invalidate() { bValid = false; }
+
+	/** @return Whether there is an arc to follow. */
+	bool IsValid() const { return bValid; }
+
+private:
+
+	FVector	Origin			= FVector::ZeroVector;
+	FVector	ClearEnd		= FVector::ZeroVector;	// Point along the chord up to which its sweep was clear.
+	double	Margin			= 0.0;					// How far from the chord the mover may be and still be inside the sweep.
+	int32	CastCooldown	= 0;	// Steps to wait before casting again, e.g. while still next to the floor we jumped off.
+	bool	bValid			= false;
+};
@@ -10,18 +10,45 @@
 #pragma once
 
 #include "MoverDataModelTypes.h"
+#include "Core/FGPooledAllocator.h"
+#include "FGMovementDefines.h"
 #include "FGDataModel.generated.h"
 
+/**
+ * FG input command. Serializes in a compact quantized format rather than the full
+ * FCharacterDefaultInputs payload - move input is 8 bits per axis, pitch and yaw are
+ * 16 bits each, buttons are packed bits and the movement base is only sent when used.
+ * Call Quantize() once the cmd is filled in, so the locally predicted cmd is bit-exact
+ * with what the server deserializes.
+ *
+ * Cmds serialized inside an FG::Net::FScopedInputBatch are delta compressed against the
+ * previous cmd of that batch (see FG.Net.DeltaInputs): an unchanged cmd is two bits,
+ * otherwise only the changed fields are sent, with small rotation deltas. The first cmd
+ * of every batch goes in full, so a lost or reordered packet can't leave the server
+ * decoding against a cmd it never got. Outside a batch cmds always go in full.
+ *
+ * NPP clones cmds constantly while buffering and resimulating, so they come from a pool.
+ */
 USTRUCT()
 struct FFGMoverInputCmd : public FCharacterDefaultInputs
 {
 	GENERATED_BODY()
 
 	FFGMoverInputCmd();
+	FG_DECLARE_POOLED_ALLOCATOR()
 
 	UPROPERTY(BlueprintReadWrite, Category = Mover)
 	bool bIsCrouchPressed;
 
+	UPROPERTY(BlueprintReadWrite, Category = Mover)
+	bool bIsSprintPressed;
+
+	/** Snap every field to the precision it is serialized with. */
+	void Quantize();
+
+	/** @return Whether the cmd asks for any movement at all - move input, jump or crouch. */
+	bool HasMoveIntent() const { return bIsJumpPressed || bIsCrouchPressed || !GetMoveInput().IsNearlyZero(); }
+
 	// @return newly allocated copy of this FCharacterDefaultInputs. Must be overridden by child classes
 	virtual FMoverDataStructBase* Clone() const override;
 	virtual bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) override;
@@ -29,3 +56,61 @@ struct FFGMoverInputCmd : public FCharacterDefaultInputs
 	virtual void ToString(FAnsiStringBuilderBase& Out) const override;
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) override { Super::AddReferencedObjects(Collector); }
 };
+
+namespace FG::Net
+{
+	/**
+	 * Opens an input batch on this thread for its lifetime - the cmds serialized inside it
+	 * share one delta baseline, which starts out empty. UFGNetworkPredictionLiaison opens
+	 * one around each input RPC it sends and receives, so the sender and receiver agree on
+	 * which cmds a delta can refer to.
+	 */
+	class FGMOVEMENT_API FScopedInputBatch
+	{
+	public:
+		FScopedInputBatch();
+		~FScopedInputBatch();
+
+		FScopedInputBatch(const FScopedInputBatch&) = delete;
+		FScopedInputBatch& operator=(const FScopedInputBatch&) = delete;
+
+	private:
+		bool bWasInBatch;
+	};
+}
+
+/**
+ * FG sync state, used by FG movers in place of FMoverDefaultSyncState (see UFGMoverComponent).
+ * Replicates in a quantized format - location at FG.Net.LocationPrecision, velocity in tenths,
+ * yaw only orientation since FG pawns are always upright, the walk mode's floorless tick
+ * count in 2 bits and its rest state in a bit or two (a byte more while counting idle ticks).
+ * The mode isn't in here, Mover replicates its name alongside.
+ * Zero velocity and zero move intent cost a bit each. Movers on a movement base fall back
+ * to the full precision FMoverDefaultSyncState format.
+ * The FG modes Quantize() their output state, so what the owning client predicts matches
+ * what the server sends and quantization never triggers a correction.
+ * Clones come from a pool, like the input cmd's.
+ */
+USTRUCT()
+struct FFGMoverSyncState : public FMoverDefaultSyncState
+{
+	GENERATED_BODY()
+	FG_DECLARE_POOLED_ALLOCATOR()
+
+	// Walk ticks in a row that ended without a floor, see FG.Walk.LostFloorTicks.
+	uint8 FloorlessTicks = 0;
+
+	// Idle walk ticks in a row, and whether that got the mover to rest - see FFGRestState.
+	uint8 IdleTicks = 0;
+	bool bResting = false;
+
+	/** Snap every field to the precision it is serialized with. */
+	void Quantize();
+
+	virtual FMoverDataStructBase* Clone() const override;
+	virtual bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) override;
+	virtual UScriptStruct* GetScriptStruct() const override { return StaticStruct(); }
+	virtual void ToString(FAnsiStringBuilderBase& Out) const override;
+	virtual bool ShouldReconcile(const FMoverDataStructBase& AuthorityState) const override;
+	virtual void Interpolate(const FMoverDataStructBase& From, const FMoverDataStructBase& To, float Pct) override;
+};
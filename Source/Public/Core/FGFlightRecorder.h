@@ -0,0 +1,115 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "FGMovementCVars.h"
+#include "FGMovementDefines.h"
+#include "Math/Vector.h"
+
+class FArchive;
+struct FFGMoverInputCmd;
+struct FFloorCheckResult;
+struct FMoverDefaultSyncState;
+struct FMoverTimeStep;
+
+/**
+ * Why a mode tick asked to change mode, stored with each flight sample.
+ */
+enum class EFGTransitionReason : uint8
+{
+	None,
+	Jump,
+	LostFloor,
+	Landed,
+	Teleport,
+	Surf,
+};
+
+/**
+ * A single compact flight recorder sample, written once per mode tick.
+ */
+struct FFGFlightSample
+{
+	enum EFlags : uint8
+	{
+		Flag_BlockingFloor	= 1 << 0,
+		Flag_WalkableFloor	= 1 << 1,
+		Flag_JumpPressed	= 1 << 2,
+		Flag_CrouchPressed	= 1 << 3,
+	};
+
+	int32				SimFrame			= 0;
+	float				SimTimeMs			= 0.0f;
+	FVector3f			Location			= FVector3f::ZeroVector;
+	FVector3f			Velocity			= FVector3f::ZeroVector;
+	FVector3f			MoveInput			= FVector3f::ZeroVector;
+	FVector3f			FloorNormal			= FVector3f::ZeroVector;
+	float				FloorDistance		= 0.0f;
+	uint8				Mode				= 0;
+	uint8				Flags				= 0;
+	EFGTransitionReason	TransitionReason	= EFGTransitionReason::None;
+
+	friend FArchive& operator<<(FArchive& Ar, FFGFlightSample& Sample);
+};
+
+/**
+ * Fixed size ring buffer of flight samples for a single mover.
+ * Replaces per tick string logging - recording is a single CVar check when disabled
+ * (FG.Recorder.Enable), and FG.Recorder.Dump writes the buffers out for offline analysis.
+ * The buffer is only allocated by the first sample recorded, so movers that never record
+ * don't pay for it, and never reallocates after that.
+ *
+ * Dump file layout (little endian):
+ *		uint32 Magic ('FGFR'), uint32 Version, uint32 NumSamples,
+ *		then NumSamples samples oldest first, each serialized field by field in declaration order.
+ */
+struct FGMOVEMENT_API FFGFlightRecorder
+{
+	static constexpr int32	Capacity	= 256;
+	static constexpr uint32	Magic		= 0x52464746; // 'FGFR'
+	static constexpr uint32	Version		= 1;
+
+	/**
+	 * Record the outcome of a mode tick. Does nothing unless FG.Recorder.Enable is set.
+	 *
+	 * @param TimeStep - The time step that was simulated.
+	 * @param ModeId - The mode that ran the tick.
+	 * @param SyncState - The final sync state of the tick.
+	 * @param InputCmd - The input the tick consumed, may be null.
+	 * @param Floor - The floor the tick found, may be null.
+	 * @param Reason - Why the tick asked for a mode change, if it did.
+	 */
+	FORCEINLINE void Record(const FMoverTimeStep& TimeStep, EFGModeId ModeId, const FMoverDefaultSyncState& SyncState,
+		const FFGMoverInputCmd* InputCmd, const FFloorCheckResult* Floor, EFGTransitionReason Reason)
+	{
+		if(FG::CVars::FlightRecorderEnabled)
+		{
+			RecordSample(TimeStep, ModeId, SyncState, InputCmd, Floor, Reason);
+		}
+	}
+
+	/** Write all recorded samples, oldest first, to an archive. */
+	void Serialize(FArchive& Ar);
+
+	/** Forget all recorded samples, keeping the buffer. */
+	void Reset() { Head = 0; Num = 0; }
+
+	int32 GetNum() const { return Num; }
+
+private:
+
+	void RecordSample(const FMoverTimeStep& TimeStep, EFGModeId ModeId, const FMoverDefaultSyncState& SyncState,
+		const FFGMoverInputCmd* InputCmd, const FFloorCheckResult* Floor, EFGTransitionReason Reason);
+
+	TArray<FFGFlightSample> Samples;	// Empty until the first sample, Capacity after.
+	int32 Head	= 0;	// Next slot to write to.
+	int32 Num	= 0;	// Number of valid samples.
+};
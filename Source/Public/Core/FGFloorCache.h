@@ -0,0 +1,132 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Core/FGFloorHistory.h"
+#include "MoveLibrary/FloorQueryUtils.h"
+
+struct FFGMoverCostStats;
+class UPrimitiveComponent;
+class USceneComponent;
+
+/**
+ * Temporal floor cache for a single mover.
+ * Remembers the last floor hit - walkable or a surf ramp. As long as the mover stays on the same
+ * floor (same shape, the floor primitive hasn't moved and we only slid along the hit's plane) the
+ * hit is reprojected by the location delta instead of sweeping again. How far it may slide depends
+ * on what it's standing on: on the face of a primitive whose collision is a single box one hit tells
+ * us what the rest of the surface looks like, so anywhere the whole footprint is still on the face.
+ * On anything else (meshes, hulls) only within FG.FloorCache.ReuseDistance of where it last swept.
+ * Every FG.FloorCache.MaxReuse ticks a real sweep is forced, so other primitives put down on
+ * the floor are picked up shortly after.
+ * The result of the latest query is kept as well, so the next generate step can read it
+ * without copying it out of the blackboard.
+ * A query can also be run a frame ahead by UFGMovementSubsystem's batch (Prefetch), and is
+ * picked up by the next query from the same spot as long as the floor it hit hasn't moved.
+ * Only prefetched hits are kept, a miss can't tell whether something moved in since.
+ * Replayed frames first look in the per frame history (FFGFloorHistory).
+ */
+struct FGMOVEMENT_API FFGFloorCache
+{
+	/**
+	 * Find the floor at a location, reusing the cached floor where possible.
+	 *
+	 * @param Stats - Sweep stats of the mover, only bumped when we actually sweep.
+	 * @param UpdatedComponent - The mover's updated component.
+	 * @param UpdatedPrimitive - The mover's collision primitive.
+	 * @param FloorSweepDistance - How far down to sweep for the floor.
+	 * @param MaxWalkSlopeCosine - Slope limit for a walkable floor.
+	 * @param Location - Where to find the floor from.
+	 * @param ServerFrame - The sim frame the query is for, to find it again when the frame is replayed.
+	 * @param SimTimeMs - Sim time the query's substep starts at, tells substeps of the same frame apart.
+	 * @param bCanRollBack - Whether the mover's frames can be replayed at all, the floor history is only kept if so.
+	 * @param Frame - The current game frame, see UFGMoverComponent::GetMovementFrame.
+	 * @return The found (or reprojected) floor, valid until the next query.
+	 */
+	const FFloorCheckResult& FindFloor(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+		float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, int32 ServerFrame, double SimTimeMs, bool bCanRollBack, uint64 Frame);
+
+	/**
+	 * Sweep for the floor ahead of the query that needs it, unless the cache could answer it.
+	 * Keeps the result only if it hit something.
+	 * Safe to run on any thread as long as the game thread isn't moving anything.
+	 *
+	 * @param Stats - Sweep stats of the mover, bumped if we sweep.
+	 * @param UpdatedComponent - The mover's updated component.
+	 * @param UpdatedPrimitive - The mover's collision primitive.
+	 * @param FloorSweepDistance - How far down to sweep for the floor.
+	 * @param MaxWalkSlopeCosine - Slope limit for a walkable floor.
+	 * @param Location - Where the next query is expected to be made from.
+	 * @param Frame - The current game frame, the prefetched floor is only used in the next one.
+	 */
+	void Prefetch(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+		float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, uint64 Frame);
+
+	/** @return The result of the latest query, null if there hasn't been one. */
+	const FFloorCheckResult* GetLastFloor() const { return bHasLastFloor ? &LastFloor : nullptr; }
+
+	/** Forget the cached floor, the next query will always sweep. Call on teleports and the like. */
+	void Invalidate() { bValid = false; bPrefetched = false; }
+
+private:
+
+	/** Find the floor into LastFloor from the cache, the prefetched floor or a sweep. */
+	void QueryFloor(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+		float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, uint64 Frame);
+
+	bool CanReuse(const UPrimitiveComponent* UpdatedPrimitive, float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location) const;
+
+	/** Face of a box, in world space. */
+	struct FFloorFace
+	{
+		FVector	Origin	= FVector::ZeroVector;	// Center of the face.
+		FVector	Normal	= FVector::UpVector;
+		FVector	AxisU	= FVector::ForwardVector;
+		FVector	AxisV	= FVector::RightVector;
+		double	HalfU	= 0.0;
+		double	HalfV	= 0.0;
+	};
+
+	/** @return Whether the floor's collision is a single box and the hit is flat on one of its faces, which goes to OutFace. */
+	static bool FindFloorFace(const UPrimitiveComponent& FloorPrimitive, const FHitResult& Hit, FFloorFace& OutFace);
+
+	/** Move the prefetched floor into OutFloorResult if it answers this query. Always uses up the prefetched floor. */
+	bool ConsumePrefetch(const UPrimitiveComponent* UpdatedPrimitive, float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location,
+		uint64 Frame, FFloorCheckResult& OutFloorResult);
+
+	FFloorCheckResult						CachedFloor;
+	FFloorCheckResult						LastFloor;
+	FTransform								CachedFloorTransform;
+	FFloorFace								CachedFace;
+	FVector									CachedLocation		= FVector::ZeroVector;
+	FVector									CachedShapeExtent	= FVector::ZeroVector;
+	TWeakObjectPtr<const UPrimitiveComponent>	CachedFloorPrimitive;
+	TWeakObjectPtr<const UPrimitiveComponent>	CachedUpdatedPrimitive;
+	float									CachedSweepDistance	= 0.0f;
+	float									CachedSlopeCosine	= 0.0f;
+	int32									NumReuses			= 0;
+	bool									bValid				= false;
+	bool									bOnFace				= false;	// CachedFace is the box face we stand on.
+	bool									bHasLastFloor		= false;
+
+	// Floor swept a frame ahead, see Prefetch.
+	FFloorCheckResult						PrefetchedFloor;
+	FTransform								PrefetchedFloorTransform;
+	FVector									PrefetchedLocation	= FVector::ZeroVector;
+	TWeakObjectPtr<const UPrimitiveComponent>	PrefetchedFloorPrimitive;
+	TWeakObjectPtr<const UPrimitiveComponent>	PrefetchedUpdatedPrimitive;
+	float									PrefetchedSweepDistance	= 0.0f;
+	float									PrefetchedSlopeCosine	= 0.0f;
+	uint64									PrefetchedFrame		= 0;
+	bool									bPrefetched			= false;
+
+	// Floors of the last few sim frames, for replays.
+	FFGFloorHistory							History;
+};
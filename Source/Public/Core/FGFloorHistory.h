@@ -0,0 +1,67 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Containers/StaticArray.h"
+#include "Math/Transform.h"
+#include "MoveLibrary/FloorQueryUtils.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UPrimitiveComponent;
+
+/**
+ * The floors a single mover found over its last few sim frames, keyed by server frame and the
+ * sim time the query's substep started at, so a mode change mid frame doesn't overwrite the
+ * frame's first floor. Only kept where frames can be replayed, see FFGFloorCache::FindFloor.
+ * When Network Prediction corrects a mover it replays every frame since the correction,
+ * and most of those replays start close enough to where the frame started the first time
+ * that the floor is the same - so as long as the start location is within
+ * FG.FloorHistory.Tolerance and whatever we stood on hasn't moved, the recorded floor is
+ * reused instead of sweeping again. Like the floor cache this isn't rolled back, it only
+ * ever stands in for a query that would have found the same floor.
+ */
+struct FGMOVEMENT_API FFGFloorHistory
+{
+	static constexpr int32 Capacity = 64;
+
+	/**
+	 * Look up the floor found the last time a frame was simulated.
+	 *
+	 * @param ServerFrame - The frame being simulated.
+	 * @param SimTimeMs - Sim time the substep being simulated starts at.
+	 * @param Location - Where the floor is being looked for from this time around.
+	 * @param OutFloor - The recorded floor, moved along by however far Location is from where it was found.
+	 * @return Whether the frame was recorded from close enough to Location and its floor is still there.
+	 */
+	bool Find(int32 ServerFrame, double SimTimeMs, const FVector& Location, FFloorCheckResult& OutFloor) const;
+
+	/**
+	 * Remember the floor found by a frame's substep. Each frame has one slot: its first substep is
+	 * kept, later substeps of the same frame are dropped, and a replay of the frame replaces it.
+	 */
+	void Record(int32 ServerFrame, double SimTimeMs, const FVector& Location, const FFloorCheckResult& Floor);
+
+	/** Forget every recorded frame. */
+	void Reset();
+
+private:
+
+	struct FEntry
+	{
+		FFloorCheckResult							Floor;
+		FTransform									FloorTransform;
+		FVector										Location		= FVector::ZeroVector;
+		TWeakObjectPtr<const UPrimitiveComponent>	FloorPrimitive;
+		double										SimTimeMs		= 0.0;
+		int32										ServerFrame		= INDEX_NONE;
+	};
+
+	TStaticArray<FEntry, Capacity> Entries;
+};
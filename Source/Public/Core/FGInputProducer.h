@@ -0,0 +1,147 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "UObject/Object.h"
+#include "FGInputProducer.generated.h"
+
+class AFGPawn;
+class UWorld;
+struct FFGMoverInputCmd;
+
+/**
+ * Produces the input cmds of an AFGPawn in place of its controller, see AFGPawn::InputProducer.
+ * Runs on whichever side produces the pawn's input - the owning client, or the server for
+ * pawns nobody controls - so no PlayerController is needed.
+ */
+UCLASS(Abstract, EditInlineNew, DefaultToInstanced, BlueprintType)
+class FGMOVEMENT_API UFGInputProducer : public UObject
+{
+	GENERATED_BODY()
+public:
+
+	/**
+	 * Fill in the cmd for a sim frame. The pawn quantizes it afterwards.
+	 *
+	 * @param Pawn - The pawn the input is for.
+	 * @param SimTimeMs - The sim time the cmd is produced for.
+	 * @param OutCmd - The cmd to fill in.
+	 */
+	virtual void ProduceInput(AFGPawn& Pawn, int32 SimTimeMs, FFGMoverInputCmd& OutCmd) PURE_VIRTUAL(UFGInputProducer::ProduceInput, );
+};
+
+/** Movement patterns of UFGSyntheticInputProducer. */
+UENUM(BlueprintType)
+enum class EFGSyntheticMovement : uint8
+{
+	Wander,			// Walk or sprint in a new direction every couple of seconds, with the odd stop.
+	StrafeJump,		// Hold forward and jump, swapping strafe side and view sweep every half second.
+	CrouchSpam,		// Walk while toggling crouch four times a second.
+	SurfRun,		// Hold strafe without forward while turning slowly, the surf technique.
+	Mixed,			// One of the above, picked by the seed.
+};
+
+/**
+ * Scripted movement for load testing. Every decision is a hash of the seed and the sim
+ * time, so a pawn with the same seed moves the same way on every run no matter how often
+ * input is produced.
+ */
+UCLASS()
+class FGMOVEMENT_API UFGSyntheticInputProducer : public UFGInputProducer
+{
+	GENERATED_BODY()
+public:
+
+	//~ Begin UFGInputProducer
+	virtual void ProduceInput(AFGPawn& Pawn, int32 SimTimeMs, FFGMoverInputCmd& OutCmd) override;
+	//~ End UFGInputProducer
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Synthetic Input")
+	EFGSyntheticMovement Movement = EFGSyntheticMovement::Mixed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Synthetic Input")
+	int32 Seed = 0;
+};
+
+/** One step of a UFGScriptedInputProducer script. */
+USTRUCT(BlueprintType)
+struct FGMOVEMENT_API FFGScriptedInputStep
+{
+	GENERATED_BODY()
+
+	// How long the step's input is held for.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scripted Input")
+	int32 DurationMs = 1000;
+
+	// Move intent relative to the view, X forward and Y right.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scripted Input")
+	FVector MoveInput = FVector::ZeroVector;
+
+	// View yaw in degrees.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scripted Input")
+	float Yaw = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scripted Input")
+	bool bJump = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scripted Input")
+	bool bCrouch = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scripted Input")
+	bool bSprint = false;
+};
+
+/**
+ * Plays a fixed list of input steps, starting from the first cmd it produces. Once the list
+ * runs out the pawn stands still, facing the last step's yaw.
+ */
+UCLASS()
+class FGMOVEMENT_API UFGScriptedInputProducer : public UFGInputProducer
+{
+	GENERATED_BODY()
+public:
+
+	//~ Begin UFGInputProducer
+	virtual void ProduceInput(AFGPawn& Pawn, int32 SimTimeMs, FFGMoverInputCmd& OutCmd) override;
+	//~ End UFGInputProducer
+
+	/** @return How long the whole script runs for. */
+	int32 GetDurationMs() const;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scripted Input")
+	TArray<FFGScriptedInputStep> Steps;
+
+private:
+
+	// Sim time of the first cmd, unset until then.
+	int32 StartTimeMs = INDEX_NONE;
+};
+
+namespace FG::SyntheticInput
+{
+	/**
+	 * Spawn FG pawns driven by synthetic input on a square grid, each with its own seed.
+	 *
+	 * @param World - The server or standalone world to spawn in.
+	 * @param Origin - Center of the grid.
+	 * @param Count - How many pawns to spawn.
+	 * @param Movement - What the pawns do.
+	 * @param Seed - Seed of the first pawn, the rest count up from it.
+	 * @param Spacing - Distance between neighbouring pawns.
+	 * @return The spawned pawns.
+	 */
+	FGMOVEMENT_API TArray<AFGPawn*> SpawnPawns(UWorld& World, const FVector& Origin, int32 Count, EFGSyntheticMovement Movement, int32 Seed, float Spacing);
+
+	/** Destroy every pawn SpawnPawns spawned in a world. @return How many were destroyed. */
+	FGMOVEMENT_API int32 DestroyPawns(UWorld& World);
+
+	/** @return The first server or standalone game world, synthetic pawns only make sense there. */
+	FGMOVEMENT_API UWorld* FindAuthorityWorld();
+}
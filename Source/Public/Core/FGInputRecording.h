@@ -0,0 +1,125 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Core/FGKinematics.h"
+#include "FGMovementDefines.h"
+#include "Math/Rotator.h"
+#include "Math/Vector.h"
+
+class FArchive;
+struct FFGMoverInputCmd;
+
+/**
+ * One recorded input cmd, in the same quantized precision it goes over the wire, plus where
+ * the pawn was when it produced it so a replay can tell when it drifts off.
+ * Only directional move input is kept, which is all FG pawns produce. The movement base and
+ * suggested mode aren't kept either.
+ */
+struct FGMOVEMENT_API FFGInputSample
+{
+	enum EFlags : uint8
+	{
+		Flag_HasOrientation	= 1 << 0,
+	};
+
+	int32		SimTimeMs			= 0;	// Since the first recorded cmd.
+	FVector3f	Location			= FVector3f::ZeroVector;
+	int8		MoveInput[3]		= { 0, 0, 0 };
+	uint8		Buttons				= 0;
+	uint16		OrientationPitch	= 0;
+	uint16		OrientationYaw		= 0;
+	uint16		ControlPitch		= 0;
+	uint16		ControlYaw			= 0;
+	uint8		Mode				= 0;
+	uint8		Flags				= 0;
+
+	/** Store a cmd. Implemented next to the wire format, so a replayed cmd is bit-exact with the recorded one. */
+	void Pack(const FFGMoverInputCmd& Cmd);
+
+	/** Restore the stored cmd. */
+	void Unpack(FFGMoverInputCmd& Cmd) const;
+
+	friend FArchive& operator<<(FArchive& Ar, FFGInputSample& Sample);
+};
+
+/**
+ * The input cmds one pawn produced over a play session, with the state and tuning it
+ * started from, for reproducing perf captures and bugs from real sessions.
+ * See FG.Input.Record, FG.Input.Stop and FG.Input.Replay.
+ *
+ * File layout (little endian), fixed size so it can be streamed or memory mapped:
+ *		uint32 Magic ('FGIR'), uint32 Version, uint32 NumSamples,
+ *		FVector StartLocation, FRotator StartRotation, FVector StartVelocity, uint8 StartMode,
+ *		FFGMovementTuning fields as floats in declaration order,
+ *		then NumSamples samples of SampleSize bytes, each serialized field by field in declaration order.
+ */
+struct FGMOVEMENT_API FFGInputRecording
+{
+	static constexpr uint32	Magic	= 0x52494746; // 'FGIR'
+	static constexpr uint32	Version	= 1;
+	static constexpr int32	SampleSize	= 30;	// Serialized size of an FFGInputSample.
+
+	FVector					StartLocation	= FVector::ZeroVector;
+	FRotator				StartRotation	= FRotator::ZeroRotator;
+	FVector					StartVelocity	= FVector::ZeroVector;
+	EFGModeId				StartMode		= EFGModeId::None;
+	FFGMovementTuning		Tuning;
+	TArray<FFGInputSample>	Samples;
+
+	/** Append a cmd the pawn produced at Location. */
+	void Record(int32 SimTimeMs, const FVector& Location, EFGModeId Mode, const FFGMoverInputCmd& Cmd);
+
+	void Serialize(FArchive& Ar);
+
+	bool SaveToFile(const FString& Path);
+	bool LoadFromFile(const FString& Path);
+
+private:
+
+	int32 StartSimTimeMs = 0;
+};
+
+/**
+ * Plays a recording back through a pawn's input producer, one cmd per produced input,
+ * and tracks how far the pawn drifts from the recorded trajectory.
+ */
+struct FGMOVEMENT_API FFGInputReplay
+{
+	FFGInputRecording Recording;
+
+	// The pawn's own tuning, put back once the replay is done.
+	FFGMovementTuning	PreviousTuning;
+	bool				bPreviousTuningOverrides	= true;
+
+	/** @return Whether every recorded cmd was played. */
+	bool IsFinished() const { return Cursor >= Recording.Samples.Num(); }
+
+	/**
+	 * Produce the next recorded cmd.
+	 *
+	 * @param SimTimeMs - The sim time the cmd is produced for.
+	 * @param Location - Where the pawn is, checked against where it was when the cmd was recorded.
+	 * @param OutCmd - The recorded cmd.
+	 * @param Owner - Used to name the pawn when reporting a divergence.
+	 */
+	void Next(int32 SimTimeMs, const FVector& Location, FFGMoverInputCmd& OutCmd, const UObject* Owner);
+
+	/** Log how closely the replay followed the recording. */
+	void Report(const UObject* Owner) const;
+
+private:
+
+	int32	Cursor				= 0;
+	int32	StartSimTimeMs		= 0;
+	int32	FirstDivergence		= INDEX_NONE;
+	int32	FirstTimingMismatch	= INDEX_NONE;
+	float	MaxError			= 0.0f;
+};
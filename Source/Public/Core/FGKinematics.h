@@ -0,0 +1,198 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Math/Vector.h"
+#include "Math/UnrealMathUtility.h"
+
+/**
+ * Plain tuning values consumed by the FG kinematics kernel and the FG modes.
+ * Baked from a UFGMovementSettings asset (or left at the defaults), carries no engine
+ * state and fits in a single cache line, so it can be snapshotted once per tick.
+ */
+struct alignas(PLATFORM_CACHE_LINE_SIZE) FFGMovementTuning
+{
+	float GroundSpeed			= 1200.0f;
+	float AirSpeed				= 1200.0f;
+	float GroundDamping			= 6.0f;
+	float AirDamping			= 5.0f;
+	float GroundAcceleration	= 8.0f;
+	float AirAcceleration		= 2.0f;
+	float SlipFactor			= 750.0f;
+	float GravitySpeed			= 800.0f;
+	float JumpForce				= 300.0f;
+	float CrouchSpeedMult		= 0.75f;
+	float SprintSpeedMult		= 1.5f;
+};
+
+static_assert(sizeof(FFGMovementTuning) == PLATFORM_CACHE_LINE_SIZE, "FFGMovementTuning should stay a single cache line.");
+
+/**
+ * Which set of tuning constants a kinematics step should use.
+ */
+enum class EFGMoveSurface : uint8
+{
+	None,
+	Ground,
+	Air,
+};
+
+/**
+ * Engine-free movement math. Everything in here works on plain values so it can
+ * be called from the movement modes, Blueprint wrappers and benchmarks alike.
+ */
+namespace FG::Kinematics
+{
+	// Same behaviour as UKismetMathLibrary::NormalizeToRange, without pulling in Engine.
+	FORCEINLINE double NormalizeToRange(double Value, double RangeMin, double RangeMax)
+	{
+		if (RangeMin == RangeMax)
+		{
+			return Value < RangeMin ? 0.0 : 1.0;
+		}
+
+		if (RangeMin > RangeMax)
+		{
+			Swap(RangeMin, RangeMax);
+		}
+
+		return (Value - RangeMin) / (RangeMax - RangeMin);
+	}
+
+	/**
+	 * The tuning constants of one surface, picked at compile time.
+	 * No surface has no damping or acceleration at all.
+	 */
+	template<EFGMoveSurface Surface>
+	struct TSurfaceConstants
+	{
+		static FORCEINLINE double IntentSpeed(const FFGMovementTuning& Tuning)
+		{
+			if constexpr (Surface == EFGMoveSurface::Ground) { return Tuning.GroundSpeed; }
+			else if constexpr (Surface == EFGMoveSurface::Air) { return Tuning.AirSpeed; }
+			else { return 0.0; }
+		}
+
+		static FORCEINLINE double Damping(const FFGMovementTuning& Tuning)
+		{
+			if constexpr (Surface == EFGMoveSurface::Ground) { return Tuning.GroundDamping; }
+			else if constexpr (Surface == EFGMoveSurface::Air) { return Tuning.AirDamping; }
+			else { return 0.0; }
+		}
+
+		static FORCEINLINE double Acceleration(const FFGMovementTuning& Tuning)
+		{
+			if constexpr (Surface == EFGMoveSurface::Ground) { return Tuning.GroundAcceleration; }
+			else if constexpr (Surface == EFGMoveSurface::Air) { return Tuning.AirAcceleration; }
+			else { return 0.0; }
+		}
+	};
+
+	/**
+	 * Apply damper force to a velocity, applying any ground friction or drag.
+	 *
+	 * @param Surface - Whether the ground or air constants should be used.
+	 * @param Velocity - The velocity to damp, modified in place.
+	 * @param Tuning - Tuning values to read the damper and intent speed from.
+	 * @param DeltaTime - Time passed since last tick.
+	 */
+	template<EFGMoveSurface Surface>
+	FORCEINLINE void ApplyDamping(FVector& Velocity, const FFGMovementTuning& Tuning, float DeltaTime)
+	{
+		const double Damper = TSurfaceConstants<Surface>::Damping(Tuning);
+		const double IntentSpeed = TSurfaceConstants<Surface>::IntentSpeed(Tuning);
+
+		const double Speed = Velocity.Size();
+
+		const double DragFactor = NormalizeToRange(FMath::Max<double>(Tuning.SlipFactor, Speed), 0.0, IntentSpeed);
+		const double Drag = Damper * DragFactor; // Drag is a function of speed and the damper.
+
+		Velocity += -Velocity * Drag * DeltaTime; // Apply counter force.
+	}
+
+	/** ApplyDamping with the surface picked at runtime. */
+	FORCEINLINE void ApplyDamping(FVector& Velocity, const FFGMovementTuning& Tuning, EFGMoveSurface Surface, float DeltaTime)
+	{
+		switch(Surface)
+		{
+		case EFGMoveSurface::Ground:	ApplyDamping<EFGMoveSurface::Ground>(Velocity, Tuning, DeltaTime); break;
+		case EFGMoveSurface::Air:		ApplyDamping<EFGMoveSurface::Air>(Velocity, Tuning, DeltaTime); break;
+		default:						ApplyDamping<EFGMoveSurface::None>(Velocity, Tuning, DeltaTime); break;
+		}
+	}
+
+	/**
+	 * Project a velocity onto a direction intent, accelerating towards the new direction.
+	 *
+	 * @param Surface - Whether the ground or air constants should be used.
+	 * @param Velocity - The velocity to accelerate, modified in place.
+	 * @param Tuning - Tuning values to read the acceleration constant from.
+	 * @param DeltaTime - Time passed since last tick.
+	 * @param DirectionIntent - The direction to accelerate in.
+	 * @param DesiredSpeed - The speed to accelerate to.
+	 */
+	template<EFGMoveSurface Surface>
+	FORCEINLINE void ApplyAcceleration(FVector& Velocity, const FFGMovementTuning& Tuning, float DeltaTime, const FVector& DirectionIntent, float DesiredSpeed)
+	{
+		const double Acceleration = DesiredSpeed * TSurfaceConstants<Surface>::Acceleration(Tuning) * DeltaTime;
+
+		const double ProjectedCurrentVelocity = Velocity | DirectionIntent;
+		const double MissingSpeed = FMath::Max(DesiredSpeed - ProjectedCurrentVelocity, 0.0);
+		const double ScaledAcceleration = Acceleration * (MissingSpeed / DesiredSpeed);
+
+		Velocity += DirectionIntent * ScaledAcceleration;
+	}
+
+	/** ApplyAcceleration with the surface picked at runtime. */
+	FORCEINLINE void ApplyAcceleration(FVector& Velocity, const FFGMovementTuning& Tuning, EFGMoveSurface Surface, float DeltaTime, const FVector& DirectionIntent, float DesiredSpeed)
+	{
+		switch(Surface)
+		{
+		case EFGMoveSurface::Ground:	ApplyAcceleration<EFGMoveSurface::Ground>(Velocity, Tuning, DeltaTime, DirectionIntent, DesiredSpeed); break;
+		case EFGMoveSurface::Air:		ApplyAcceleration<EFGMoveSurface::Air>(Velocity, Tuning, DeltaTime, DirectionIntent, DesiredSpeed); break;
+		default:						ApplyAcceleration<EFGMoveSurface::None>(Velocity, Tuning, DeltaTime, DirectionIntent, DesiredSpeed); break;
+		}
+	}
+
+	/**
+	 * Apply constant downwards gravity to a velocity.
+	 *
+	 * @param Velocity - The velocity to apply gravity to, modified in place.
+	 * @param Tuning - Tuning values to read the gravity speed from.
+	 * @param DeltaTime - Time passed since last tick.
+	 */
+	FORCEINLINE void ApplyGravity(FVector& Velocity, const FFGMovementTuning& Tuning, float DeltaTime)
+	{
+		Velocity -= FVector::UpVector * Tuning.GravitySpeed * DeltaTime;
+	}
+
+	/** @return Where a ballistic arc under FG gravity is at a time after its start. */
+	FORCEINLINE FVector BallisticLocation(const FVector& Origin, const FVector& Velocity, float GravitySpeed, double Time)
+	{
+		return Origin + Velocity * Time - FVector::UpVector * (0.5 * GravitySpeed * Time * Time);
+	}
+
+	/** Remove the part of a velocity going into a surface, leaving it moving along the surface's plane. */
+	FORCEINLINE void ClipToSurface(FVector& Velocity, const FVector& Normal)
+	{
+		const double IntoSurface = Velocity | Normal;
+		if(IntoSurface < 0.0)
+		{
+			Velocity -= Normal * IntoSurface;
+		}
+	}
+
+	/** @return The furthest a ballistic arc strays from its chord over a duration, reached halfway through. */
+	FORCEINLINE double BallisticSagitta(float GravitySpeed, double Duration)
+	{
+		return GravitySpeed * Duration * Duration * 0.125;
+	}
+}
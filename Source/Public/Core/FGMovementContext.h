@@ -0,0 +1,53 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Core/FGKinematics.h"
+
+class UBaseMovementMode;
+class UFGMoverComponent;
+class UPrimitiveComponent;
+class USceneComponent;
+struct FFGMoverCostStats;
+struct FFGMoverInputCmd;
+struct FFGMoverSyncState;
+struct FFloorCheckResult;
+struct FMoverTickStartData;
+struct FSimulationTickParams;
+
+/**
+ * Everything an FG mode needs for one generate or simulate call - typed input and sync state,
+ * the mover and its components, the last floor and the tuning - resolved once up front and
+ * then handed to the mode code and the FG utils by reference.
+ */
+struct FGMOVEMENT_API FFGMovementContext
+{
+	/** Context for OnGenerateMove. */
+	FFGMovementContext(const UBaseMovementMode& Mode, const FMoverTickStartData& StartState);
+
+	/** Context for OnSimulationTick. */
+	FFGMovementContext(const UBaseMovementMode& Mode, const FSimulationTickParams& Params);
+
+	UFGMoverComponent&			MoverComp;
+	FFGMoverCostStats&			CostStats;
+	const FFGMoverInputCmd&		Input;				// A default cmd if the start state has none.
+	const FFGMoverSyncState&	StartSyncState;
+	USceneComponent*			UpdatedComponent;
+	UPrimitiveComponent*		UpdatedPrimitive;
+	const FFloorCheckResult*	LastFloor;			// Floor found by the last FG sim tick, null if none.
+	FFGMovementTuning			Tuning;				// Snapshot of the mover's tuning for this call.
+
+private:
+
+	FFGMovementContext(UFGMoverComponent& InMoverComp, const FMoverTickStartData& StartState);
+
+	FFGMovementContext(UFGMoverComponent& InMoverComp, const FMoverTickStartData& StartState,
+		USceneComponent* InUpdatedComponent, UPrimitiveComponent* InUpdatedPrimitive);
+};
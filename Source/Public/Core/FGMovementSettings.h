@@ -0,0 +1,72 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Engine/DataAsset.h"
+#include "Core/FGKinematics.h"
+#include "FGMovementSettings.generated.h"
+
+/**
+ * Movement tuning for one pawn archetype, referenced by UFGMoverComponent.
+ * Baked into a single FFGMovementTuning block when the mover starts, which the modes
+ * snapshot once per tick. Any FG.Move CVar set from the console or an ini overrides the
+ * matching value on every mover, for debugging.
+ */
+UCLASS(BlueprintType)
+class FGMOVEMENT_API UFGMovementSettings final : public UDataAsset
+{
+public:
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ground", meta = (ClampMin = "0"))
+	float GroundSpeed = 1200.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ground", meta = (ClampMin = "0"))
+	float GroundDamping = 6.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ground", meta = (ClampMin = "0"))
+	float GroundAcceleration = 8.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ground", meta = (ClampMin = "0"))
+	float SlipFactor = 750.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ground", meta = (ClampMin = "0"))
+	float CrouchSpeedMult = 0.75f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ground", meta = (ClampMin = "0"))
+	float SprintSpeedMult = 1.5f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Air", meta = (ClampMin = "0"))
+	float AirSpeed = 1200.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Air", meta = (ClampMin = "0"))
+	float AirDamping = 5.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Air", meta = (ClampMin = "0"))
+	float AirAcceleration = 2.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Air")
+	float GravitySpeed = 800.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Air", meta = (ClampMin = "0"))
+	float JumpForce = 300.0f;
+
+	/** @return The settings packed into a tuning block. */
+	FFGMovementTuning ToTuning() const;
+};
+
+namespace FG::Tuning
+{
+	/** Overwrite the values of any FG.Move CVar that was set by something other than its default. */
+	FGMOVEMENT_API void ApplyCVarOverrides(FFGMovementTuning& Tuning);
+
+	/** Re-check which FG.Move CVars are overridden. Runs automatically whenever a CVar changes. */
+	FGMOVEMENT_API void RefreshCVarOverrides();
+}
@@ -0,0 +1,107 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "HAL/PlatformTime.h"
+#include "FGMovementDefines.h"
+
+struct FMoverDefaultSyncState;
+
+/**
+ * Per mover cost and trajectory tracking for the FG modes.
+ * Every mode tick adds its wall time and sweep count in here, and once the tick has
+ * finished the final sync state is folded into a running trajectory hash. Two runs
+ * fed with the same inputs should end up with the same hash, which is what the
+ * FG.Golden console commands compare against.
+ */
+struct FGMOVEMENT_API FFGMoverCostStats
+{
+	// Counters for the tick currently being simulated.
+	uint32	TickSweeps				= 0;
+	uint64	TickGenerateCycles		= 0;
+	uint64	TickSimulateCycles		= 0;
+
+	// Totals since the last reset.
+	uint64	NumTicks				= 0;
+	uint64	TotalSweeps				= 0;
+	uint64	TotalGenerateCycles		= 0;
+	uint64	TotalSimulateCycles		= 0;
+	uint32	NumOverBudgetTicks		= 0;
+	uint64	NumFloorCacheHits		= 0;
+	uint64	NumFloorPrefetchHits	= 0;	// Floors taken from UFGMovementSubsystem's batch.
+	uint64	NumResimTicks			= 0;	// Ticks replaying a frame after a correction.
+	uint64	NumFloorHistoryHits		= 0;	// Floors taken from FFGFloorHistory.
+	uint32	MaxSlideSweeps			= 0;	// Worst single slide, see FG::SlideAlongSurfaces.
+	uint32	NumWalkAirTransitions	= 0;	// Either way, see FG.Stats.Transitions.
+	double	SimSeconds				= 0.0;	// Simulated time, to turn the counts above into rates.
+	uint32	TrajectoryHash			= 0;
+
+	void Reset() { *this = FFGMoverCostStats(); }
+
+	/**
+	 * Finish the current tick - accumulates the tick counters into the totals, checks them
+	 * against the FG.Budget CVars and folds the final state into the trajectory hash.
+	 *
+	 * @param SyncState - The final sync state the tick produced.
+	 * @param ModeId - The mode that ran the tick.
+	 * @param Owner - Used to name the mover when reporting a blown budget.
+	 */
+	void CommitTick(const FMoverDefaultSyncState& SyncState, EFGModeId ModeId, const UObject* Owner);
+
+	double GetAverageTickUs() const;
+	double GetAverageSweeps() const { return NumTicks > 0 ? double(TotalSweeps) / NumTicks : 0.0; }
+	double GetWalkAirTransitionsPerSecond() const { return SimSeconds > 0.0 ? NumWalkAirTransitions / SimSeconds : 0.0; }
+};
+
+namespace FG
+{
+	/** Adds the wall time of OnGenerateMove to the tick counters. */
+	struct FScopedGenerateCost
+	{
+		explicit FScopedGenerateCost(FFGMoverCostStats& InStats)
+			: Stats(InStats)
+			, StartCycles(FPlatformTime::Cycles64())
+		{}
+
+		~FScopedGenerateCost()
+		{
+			Stats.TickGenerateCycles += FPlatformTime::Cycles64() - StartCycles;
+		}
+
+	private:
+		FFGMoverCostStats& Stats;
+		uint64 StartCycles;
+	};
+
+	/** Adds the wall time of OnSimulationTick to the tick counters, then commits the tick. */
+	struct FScopedSimulateCost
+	{
+		FScopedSimulateCost(FFGMoverCostStats& InStats, const FMoverDefaultSyncState& InOutputSyncState, EFGModeId InModeId, const UObject* InOwner)
+			: Stats(InStats)
+			, OutputSyncState(InOutputSyncState)
+			, ModeId(InModeId)
+			, Owner(InOwner)
+			, StartCycles(FPlatformTime::Cycles64())
+		{}
+
+		~FScopedSimulateCost()
+		{
+			Stats.TickSimulateCycles += FPlatformTime::Cycles64() - StartCycles;
+			Stats.CommitTick(OutputSyncState, ModeId, Owner);
+		}
+
+	private:
+		FFGMoverCostStats& Stats;
+		const FMoverDefaultSyncState& OutputSyncState;
+		EFGModeId ModeId;
+		const UObject* Owner;
+		uint64 StartCycles;
+	};
+}
@@ -0,0 +1,77 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "FGMovementSubsystem.generated.h"
+
+class UFGMoverComponent;
+
+/**
+ * Keeps track of every FG mover in a world and sweeps for all of their next floors at once at
+ * the end of each frame.
+ *
+ * Network Prediction runs each mover's generate and simulate phases back to back, mover by
+ * mover, on the game thread, and gives no hook between a frame's input being ready and its
+ * sim ticks, so neither phase can be moved off it. What can be done ahead is the floor sweep:
+ * a mover's next sim tick looks for its floor from where it stands now (FG.Parallel.FloorBatch).
+ * The subsystem runs those sweeps as one batch split over FG.Parallel.Tasks worker tasks, and
+ * the sim tick takes the result if nothing moved in between (see FFGFloorCache::Prefetch).
+ */
+UCLASS()
+class FGMOVEMENT_API UFGMovementSubsystem final : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+
+	//~ Begin UTickableWorldSubsystem
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End UTickableWorldSubsystem
+
+	//~ Begin UWorldSubsystem
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem
+
+	void RegisterMover(UFGMoverComponent* Mover);
+	void UnregisterMover(UFGMoverComponent* Mover);
+
+	const TArray<TObjectPtr<UFGMoverComponent>>& GetMovers() const { return Movers; }
+
+	/** @return How many times the subsystem has ticked, the frames prefetched floors are dated in. Counts per world, so tests ticking their own world get their own. */
+	uint64 GetFrameNumber() const { return FrameNumber; }
+
+	/** @return Where every local player is viewing from this frame, gathered once per frame for all proxy LOD picks. */
+	const TArray<FVector>& GetViewLocations();
+
+	/**
+	 * Sweep for the next floor of the first NumMovers movers.
+	 *
+	 * @param NumMovers - How many of the registered movers to sweep for.
+	 * @param NumTasks - How many tasks to split them over, 1 runs them inline on the calling thread.
+	 */
+	void PrefetchFloors(int32 NumMovers, int32 NumTasks);
+
+	/** @return Wall time spent in PrefetchFloors since the world started, in cycles. */
+	uint64 GetTotalPrefetchCycles() const { return TotalPrefetchCycles; }
+
+private:
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UFGMoverComponent>> Movers;
+
+	uint64 TotalPrefetchCycles = 0;
+
+	uint64 FrameNumber = 0;
+
+	// Local viewpoints of ViewLocationsFrame, split screen can have several.
+	TArray<FVector> ViewLocations;
+	uint64 ViewLocationsFrame = 0;
+};
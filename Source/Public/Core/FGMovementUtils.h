@@ -12,24 +12,86 @@
 #include "MoverSimulationTypes.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "MoveLibrary/MovementRecord.h"
+#include "Core/FGDataModel.h"
+#include "Core/FGKinematics.h"
+#include "Core/FGMovementContext.h"
+#include "FGMovementCVars.h"
+#include "FGMovementTrace.h"
 #include "FGMovementUtils.generated.h"
 
 class UFGMoverComponent;
 struct FProposedMove;
+struct FFloorCheckResult;
+struct FFGMoverCostStats;
 
 // @TODO: Remove or put into MovementUtils class.
 namespace FG
 {
-	FORCEINLINE bool AttemptTeleport(USceneComponent* UpdatedComponent, const FVector& TeleportPos, const FRotator& TeleportRot, const FMoverDefaultSyncState& StartingSyncState, FMoverTickEndData& Output)
+	/** @return The mover's baked tuning with any FG.Move CVar overrides applied, unless the mover turned them off. */
+	FGMOVEMENT_API FFGMovementTuning GetTuning(const UFGMoverComponent& MoverComponent);
+
+	/** @return Which tuning constants the mover's current mode should use. */
+	FGMOVEMENT_API EFGMoveSurface GetMoveSurface(const UFGMoverComponent* MoverComponent);
+
+	/** UFloorQueryUtils::FindFloor, counted towards the mover's sweep stats. */
+	FGMOVEMENT_API void FindFloor(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+		float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, FFloorCheckResult& OutFloorResult);
+
+	/** UMovementUtils::TrySafeMoveUpdatedComponent, counted towards the mover's sweep stats. */
+	FGMOVEMENT_API bool TrySafeMoveUpdatedComponent(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+		const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult& OutHit, ETeleportType Teleport, FMovementRecord& MoveRecord);
+
+	/**
+	 * FG collide and slide. Clips the rest of a blocked move against every plane it has run
+	 * into this tick (up to FG.Slide.MaxPlanes), sliding along creases between two planes and
+	 * stopping dead in corners, and never slides back against the original move. Does at most
+	 * FG.Slide.MaxSweeps sweeps, counted towards the mover's sweep stats.
+	 *
+	 * @param Stats - Sweep stats of the mover.
+	 * @param UpdatedComponent - The mover's updated component.
+	 * @param UpdatedPrimitive - The mover's collision primitive.
+	 * @param Delta - The full move that was blocked.
+	 * @param Rotation - Rotation to keep while sliding.
+	 * @param Hit - The blocking hit of the move, updated with the last slide's hit.
+	 * @param MoveRecord - Record to append the slides to.
+	 * @return The number of sweeps the slide used.
+	 */
+	FGMOVEMENT_API int32 SlideAlongSurfaces(FFGMoverCostStats& Stats, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive,
+		const FVector& Delta, const FQuat& Rotation, FHitResult& Hit, FMovementRecord& MoveRecord);
+
+	/** FG::Kinematics::ApplyDamping with the context's tuning. */
+	template<EFGMoveSurface Surface>
+	FORCEINLINE void ApplyDamping(const FFGMovementContext& Ctx, FProposedMove& Move, float DeltaTime)
 	{
+		FG::Kinematics::ApplyDamping<Surface>(Move.LinearVelocity, Ctx.Tuning, DeltaTime);
+	}
+
+	/** FG::Kinematics::ApplyAcceleration with the context's tuning. */
+	template<EFGMoveSurface Surface>
+	FORCEINLINE void ApplyAcceleration(const FFGMovementContext& Ctx, FProposedMove& Move, float DeltaTime, const FVector& DirectionIntent, float DesiredSpeed)
+	{
+		FG::Kinematics::ApplyAcceleration<Surface>(Move.LinearVelocity, Ctx.Tuning, DeltaTime, DirectionIntent, DesiredSpeed);
+	}
+
+	FORCEINLINE bool AttemptTeleport(const FFGMovementContext& Ctx, const FVector& TeleportPos, const FRotator& TeleportRot, FMoverTickEndData& Output)
+	{
+		FG_SCOPE_CYCLE(FG::AttemptTeleport);
+
+		USceneComponent* UpdatedComponent = Ctx.UpdatedComponent;
+		const FFGMoverSyncState& StartingSyncState = Ctx.StartSyncState;
+
 		if (UpdatedComponent->GetOwner()->TeleportTo(TeleportPos, TeleportRot))
 		{
-			FMoverDefaultSyncState& OutputSyncState = Output.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FMoverDefaultSyncState>();
+			FG::Trace::Count(FG::Trace::FrameCounters.Teleports);
+
+			FFGMoverSyncState& OutputSyncState = Output.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FFGMoverSyncState>();
 	
 			OutputSyncState.SetTransforms_WorldSpace(UpdatedComponent->GetComponentLocation(),
 				UpdatedComponent->GetComponentRotation(),
 				StartingSyncState.GetVelocity_WorldSpace(),
 				nullptr); // no movement base
+
+			OutputSyncState.Quantize();
 	
 			UpdatedComponent->ComponentVelocity = StartingSyncState.GetVelocity_WorldSpace();
 			return true;
@@ -39,8 +101,9 @@ namespace FG
 	}
 
 	// TODO: replace this function with simply looking at/collapsing the MovementRecord
-	FORCEINLINE void CaptureFinalState(USceneComponent* UpdatedComponent, FMovementRecord& Record, const FMoverDefaultSyncState& StartSyncState, FMoverDefaultSyncState& OutputSyncState, const float DeltaSeconds)
+	FORCEINLINE void CaptureFinalState(const FFGMovementContext& Ctx, FMovementRecord& Record, FFGMoverSyncState& OutputSyncState)
 	{
+		USceneComponent* UpdatedComponent = Ctx.UpdatedComponent;
 		const FVector FinalLocation = UpdatedComponent->GetComponentLocation();
 		const FVector FinalVelocity = Record.GetRelevantVelocity();
 		
@@ -50,6 +113,9 @@ namespace FG
 			UpdatedComponent->GetComponentRotation(),
 			FinalVelocity,
 			nullptr); // no movement base
+
+		// Predict with exactly what gets replicated.
+		OutputSyncState.Quantize();
 	
 		UpdatedComponent->ComponentVelocity = FinalVelocity;
 	}
@@ -66,6 +132,7 @@ public:
 
 	/**
 	 * Apply damper force to a proposed move, applying any ground friction or drag.
+	 * Thin wrapper over FG::Kinematics::ApplyDamping using the mover's tuning.
 	 * 
 	 * @param MoverComponent - The mover component.
 	 * @param Move - The proposed move to apply damping to.
@@ -77,6 +144,7 @@ public:
 	/**
 	 * Project current velocity onto a direction intent, accelerating towards the
 	 * new direction and outputting the new velocity to a proposed move.
+	 * Thin wrapper over FG::Kinematics::ApplyAcceleration using the mover's tuning.
 	 *
 	 * @param MoverComponent - The mover component.
 	 * @param Move - The proposed move to apply acceleration to.
@@ -10,8 +10,21 @@
 #pragma once
 
 #include "MoverComponent.h"
+#include "Core/FGMovementStats.h"
+#include "Core/FGFloorCache.h"
+#include "Core/FGFlightRecorder.h"
+#include "Core/FGKinematics.h"
+#include "Core/FGRestState.h"
+#include "Core/FGBallisticArc.h"
+#include "FGMovementDefines.h"
+#include "MoverSimulationTypes.h"
 #include "FGMoverComponent.generated.h"
 
+class UFGMovementSettings;
+class UFGMovementSubsystem;
+struct FFGMoverInputCmd;
+struct FFGMoverSyncState;
+
 UCLASS()
 class FGMOVEMENT_API UFGMoverComponent : public UMoverComponent
 {
@@ -22,9 +35,132 @@ public:
 
 	virtual FVector GetFeetLocation();
 	
+	//~ Begin UActorComponent
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End UActorComponent
+
 	//~ Begin UMoverComponent
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	virtual bool IsAirborne() const;
 	virtual bool IsOnGround() const;
+	virtual void FinalizeSmoothingFrame(const FMoverSyncState* SyncState, const FMoverAuxStateContext* AuxState) override;
+	virtual void RestoreFrame(const FMoverSyncState* SyncState, const FMoverAuxStateContext* AuxState) override;
+	virtual void SimulationTick(const FMoverTimeStep& InTimeStep, const FMoverTickStartData& SimInput, OUT FMoverTickEndData& SimOutput) override;
 	//~ End UMoverComponent
+
+	/** @return Whether the mover is sliding along a ramp too steep to walk on. */
+	bool IsSurfing() const;
+
+	/** @return The FG mode of the last finalized sync state, None if there isn't one yet. */
+	EFGModeId GetModeId() const;
+
+	/** @return Whether the last finalized sync state is at rest, see FFGRestState. */
+	bool IsResting() const;
+
+	/** Switch to another tuning asset, null for the defaults. Must happen on the server and clients alike. */
+	UFUNCTION(BlueprintCallable, Category = "FG Movement")
+	void SetMovementSettings(UFGMovementSettings* NewSettings);
+
+	/**
+	 * Use a tuning block directly, e.g. one stored with an input recording. MovementSettings are left as they are.
+	 *
+	 * @param NewTuning - The tuning to use.
+	 * @param bApplyCVarOverrides - Whether the FG.Move CVar overrides still apply on top, false if NewTuning already has them in.
+	 */
+	void SetTuning(const FFGMovementTuning& NewTuning, bool bApplyCVarOverrides = true);
+
+	/** @return Whether the FG.Move CVar overrides apply on top of GetTuning(). */
+	bool AppliesTuningOverrides() const { return bApplyTuningOverrides; }
+
+	/** @return The movement LOD of this mover, always Full unless it's a simulated proxy. */
+	EFGProxyLOD GetProxyLOD() const { return ProxyLOD; }
+
+	/** @return The tuning baked from MovementSettings, without CVar overrides - see FG::GetTuning. */
+	const FFGMovementTuning& GetTuning() const { return Tuning; }
+
+	FFGMoverCostStats&			GetCostStats() { return CostStats; }
+	const FFGMoverCostStats&	GetCostStats() const { return CostStats; }
+	FFGFloorCache&				GetFloorCache() { return FloorCache; }
+	FFGFlightRecorder&			GetFlightRecorder() { return FlightRecorder; }
+	FFGRestState&				GetRestState() { return RestState; }
+	FFGBallisticArc&			GetBallisticArc() { return BallisticArc; }
+
+	/** Wake the mover if it's at rest, so the next tick runs the full walk path. Call after pushing it around from gameplay code. */
+	UFUNCTION(BlueprintCallable, Category = "FG Movement")
+	void WakeFromRest() { RestState.Wake(); }
+
+	/**
+	 * Sweep for the floor the next sim tick will look for, from where the mover stands now.
+	 * Safe to run on any thread as long as the game thread isn't moving anything.
+	 */
+	void PrefetchFloor();
+
+	/** @return The frame number of the world's UFGMovementSubsystem, 0 without one. */
+	uint64 GetMovementFrame() const;
+
+	/** Called by the FG modes at the start of every sim tick, tells replays from new frames. */
+	void NotifySimulationTick(const FMoverTimeStep& TimeStep);
+
+	/** @return Whether the sim tick being run replays a frame after a correction. */
+	bool IsResimulating() const { return bResimulating; }
+
+protected:
+
+	UFUNCTION()
+	void OnUpdatedPrimitiveBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+		int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	/** Re-pick the LOD of a simulated proxy from the local viewpoints. */
+	void UpdateProxyLOD();
+
+	/** Switch LOD, updating overlaps and the per LOD proxy counters. FinalizeSmoothingFrame throttles by LOD. */
+	void SetProxyLOD(EFGProxyLOD NewLOD);
+
+	// Tuning of this pawn archetype, the defaults if unset.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "FG Movement")
+	TObjectPtr<UFGMovementSettings> MovementSettings;
+
+	// MovementSettings baked into one block for the modes.
+	FFGMovementTuning Tuning;
+
+	// Whether FG::GetTuning applies the CVar overrides to Tuning, see SetTuning.
+	bool bApplyTuningOverrides = true;
+
+	// Per tick cost and trajectory tracking filled in by the FG modes.
+	FFGMoverCostStats CostStats;
+
+	// The subsystem we're registered with, between BeginPlay and EndPlay.
+	UPROPERTY(Transient)
+	TObjectPtr<UFGMovementSubsystem> MovementSubsystem;
+
+	// Last walkable floor, reused by the FG modes while we slide along it.
+	FFGFloorCache FloorCache;
+
+	// Binary samples of the last few mode ticks, see FG.Recorder.Enable.
+	FFGFlightRecorder FlightRecorder;
+
+	// Whether the walk mode may skip this mover's floor and collision work, see FG.Rest.Enable.
+	FFGRestState RestState;
+
+	// The arc the air mode is following while there's no air control, see FG.Air.Ballistic.
+	FFGBallisticArc BallisticArc;
+
+	// Current movement LOD, only ever lowered for simulated proxies.
+	EFGProxyLOD ProxyLOD = EFGProxyLOD::Full;
+
+	// Whether this mover is included in the per LOD proxy counters.
+	bool bCountedAsProxy = false;
+
+	// Whether the updated primitive generated overlaps before a lowered LOD turned them off.
+	bool bRestoreOverlapEvents = false;
+
+	// World time the last smoothing frame was applied at, for Minimal LOD.
+	double LastSmoothingFrameTime = 0.0;
+
+	// Newest sim frame simulated so far, anything older is a replay.
+	int32 LatestSimFrame = INDEX_NONE;
+
+	// Whether the current sim tick is a replay.
+	bool bResimulating = false;
 };
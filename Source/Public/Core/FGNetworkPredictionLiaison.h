@@ -0,0 +1,31 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "Backends/MoverNetworkPredictionLiaison.h"
+#include "FGNetworkPredictionLiaison.generated.h"
+
+/**
+ * Network Prediction backend for FG movers. Opens an FG::Net::FScopedInputBatch around every
+ * RPC it sends and receives, so the redundant input cmds NPP packs into one client to server
+ * RPC delta compress against each other and nothing outside that RPC.
+ */
+UCLASS()
+class FGMOVEMENT_API UFGNetworkPredictionLiaison : public UMoverNetworkPredictionLiaisonComponent
+{
+	GENERATED_BODY()
+public:
+
+	//~ Begin UObject
+	virtual bool CallRemoteFunction(UFunction* Function, void* Parms, FOutParmRec* OutParms, FFrame* Stack) override;
+	virtual void ProcessEvent(UFunction* Function, void* Parms) override;
+	//~ End UObject
+};
@@ -9,12 +9,14 @@
 
 #pragma once
 
+#include "Core/FGInputRecording.h"
 #include "InputActionValue.h"
 #include "MoverSimulationTypes.h"
 #include "GameFramework/Pawn.h"
 #include "FGPawn.generated.h"
 
 struct FFGMoverInputCmd;
+class UFGInputProducer;
 class UFGMoverComponent;
 class UCapsuleComponent;
 class UCameraComponent;
@@ -42,11 +44,38 @@ public:
 	virtual void JumpCompleted();
 	virtual void Crouch();
 	virtual void CrouchCompleted();
+	virtual void Sprint();
+	virtual void SprintCompleted();
 
 	//~ Begin IMoverInputProducerInterface
 	virtual void ProduceInput_Implementation(int32 SimTimeMs, FMoverInputCmdContext& OutInputCmd) override;
 	//~ End IMoverInputProducerInterface
 
+	/** Start recording the input cmds this pawn produces, along with the state and tuning it starts from. */
+	void StartInputRecording();
+
+	/** Stop recording input and write the recording out. @return Whether there was a recording and it was written. */
+	bool StopInputRecording(const FString& Path);
+
+	/**
+	 * Put the pawn in the state a recording starts from and play its cmds in place of the controller's input.
+	 * Authority only, so the restored state isn't corrected away.
+	 * @return Whether the replay started - false if the recording didn't load or can't be restored.
+	 */
+	bool StartInputReplay(const FString& Path);
+
+	/** Stop playing a recording, reporting how it went and putting the pawn's own tuning back. */
+	void StopInputReplay();
+
+	/** Drive the pawn with a producer instead of its controller, null to go back to the controller. */
+	UFUNCTION(BlueprintCallable, Category = "FG Movement")
+	void SetInputProducer(UFGInputProducer* NewInputProducer) { InputProducer = NewInputProducer; }
+
+	UFGInputProducer* GetInputProducer() const { return InputProducer; }
+
+	bool IsRecordingInput() const { return InputRecording.IsValid(); }
+	bool IsReplayingInput() const { return InputReplay.IsValid(); }
+
 	UFGMoverComponent*	GetMoverComponent() const { return MoverComponent; }
 	UCapsuleComponent*	GetCapsuleComponent() const { return CapsuleComponent; }
 	UCameraComponent*	GetCameraComponent() const { return CameraComponent; }
@@ -62,6 +91,16 @@ private:
 	UPROPERTY(Category=Character, VisibleAnywhere, BlueprintReadOnly, meta=(AllowPrivateAccess = "true"))
 	TObjectPtr<UCameraComponent> CameraComponent;
 
+	// Produces input in place of the controller when set, e.g. scripted movement for load tests.
+	UPROPERTY(Category = Movement, EditAnywhere, Instanced, meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UFGInputProducer> InputProducer;
+
+	// Input being recorded, see FG.Input.Record.
+	TUniquePtr<FFGInputRecording> InputRecording;
+
+	// Recording being played back, see FG.Input.Replay.
+	TUniquePtr<FFGInputReplay> InputReplay;
+
 	// @TODO: This seems redundant, why aren't we just caching an entire input cmd?
 	FVector3d	LastAffirmativeMoveInput	= FVector3d::ZeroVector;	// Movement input (intent or velocity) the last time we had one that wasn't zero
 	FVector3d	CachedMoveInputIntent		= FVector3d::ZeroVector;
@@ -70,4 +109,5 @@ private:
 	FRotator3d	CachedLookInput				= FRotator3d::ZeroRotator;
 	bool		JumpButtonDown				= false;
 	bool		CrouchButtonDown				= false;
+	bool		SprintButtonDown			= false;
 };
\ No newline at end of file
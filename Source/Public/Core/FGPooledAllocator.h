@@ -0,0 +1,98 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Containers/LockFreeList.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "Templates/SharedPointer.h"
+#include "FGMovementTrace.h"
+
+LLM_DECLARE_TAG_API(FGMovement_Tick, FGMOVEMENT_API);
+
+namespace FG::Memory
+{
+	/**
+	 * Lock free free-list of fixed size blocks. Blocks are never given back to the heap while
+	 * the pool lives, so once the pool has grown to the peak number of live objects every
+	 * allocation is a pop and every free a push.
+	 * Every block that does come from the heap is counted in FG::Trace::FrameCounters.HeapAllocations.
+	 * Pools are never destroyed either (see FG_IMPLEMENT_POOLED_ALLOCATOR), objects still alive at
+	 * shutdown may be freed after every static has gone.
+	 */
+	class FGMOVEMENT_API FPool
+	{
+	public:
+
+		FPool(SIZE_T InBlockSize, uint32 InAlignment);
+		~FPool();
+
+		void* Allocate(SIZE_T Size);
+		void Free(void* Ptr, SIZE_T Size);
+
+	private:
+
+		TLockFreePointerListUnordered<void, PLATFORM_CACHE_LINE_SIZE> FreeList;
+		SIZE_T BlockSize;
+		uint32 Alignment;
+	};
+
+	/**
+	 * Reuse a cached shared object if nothing else holds on to it any more, otherwise make a new one.
+	 * For objects queued every so often (layered moves and the like) this is allocation free once
+	 * the previous one has been consumed. Making a new one is counted in HeapAllocations - it's one
+	 * block for the object and its reference controller, which no pool can serve.
+	 *
+	 * @param Cached - The cached object, replaced if it's still in use.
+	 * @return An object in its default state that only Cached refers to.
+	 */
+	template<typename T>
+	TSharedPtr<T> AcquireShared(TSharedPtr<T>& Cached)
+	{
+		if(Cached.IsValid() && Cached.IsUnique())
+		{
+			*Cached = T();
+		}
+		else
+		{
+			FG::Trace::Count(FG::Trace::FrameCounters.HeapAllocations);
+			Cached = MakeShared<T>();
+		}
+
+		return Cached;
+	}
+}
+
+/**
+ * Tag every heap allocation made on this thread inside the enclosing scope as FGMovement/Tick in
+ * LLM (-llm, stat LLMFULL), which Memory Insights also lists with -trace=memalloc,memtag. Once the
+ * FG pools have warmed up, whatever is still allocated under the tag comes from engine code.
+ */
+#define FG_SCOPE_TICK_ALLOCATIONS() LLM_SCOPE_BYTAG(FGMovement_Tick)
+
+/**
+ * Route heap allocations of a struct through a FG::Memory::FPool.
+ * Put FG_DECLARE_POOLED_ALLOCATOR() in the struct, and FG_IMPLEMENT_POOLED_ALLOCATOR(Type) in its .cpp.
+ * Derived types of a different size fall through to the regular heap.
+ */
+#define FG_DECLARE_POOLED_ALLOCATOR() \
+	static void* operator new(size_t Size); \
+	static void operator delete(void* Ptr, size_t Size); \
+	static void* operator new(size_t Size, void* Placement) { return Placement; } \
+	static void operator delete(void* Ptr, void* Placement) {}
+
+#define FG_IMPLEMENT_POOLED_ALLOCATOR(Type) \
+	static FG::Memory::FPool& Get##Type##Pool() \
+	{ \
+		/* Leaked on purpose, pooled objects can outlive static destruction. */ \
+		static FG::Memory::FPool& Pool = *new FG::Memory::FPool(sizeof(Type), alignof(Type)); \
+		return Pool; \
+	} \
+	void* Type::operator new(size_t Size) { return Get##Type##Pool().Allocate(Size); } \
+	void Type::operator delete(void* Ptr, size_t Size) { Get##Type##Pool().Free(Ptr, Size); }
@@ -0,0 +1,61 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Math/Transform.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+struct FFGMoverInputCmd;
+struct FFGMoverSyncState;
+struct FFloorCheckResult;
+struct FProposedMove;
+class UPrimitiveComponent;
+
+/**
+ * Rest tracking of a single walking mover.
+ * Once a mover has sat on a walkable floor with no input and next to no velocity for
+ * FG.Rest.Ticks walk ticks in a row it goes to rest, and the walk mode stops doing any
+ * floor or collision work for it - it just holds its transform. It wakes as soon as input
+ * arrives, something proposes a move (layered moves, impulses), the floor it rests on
+ * moves or goes away, it's teleported or something overlaps it.
+ * The idle tick count and the resting flag live in the sync state (FFGMoverSyncState), so
+ * they're rolled back and replayed with everything else, and a resting flag that differs from
+ * the server's triggers a correction. This only keeps what isn't part of the simulation - the
+ * floor being watched and wake requests from overlaps and gameplay code, which are local to
+ * each side. Neither is rolled back, and neither has to be: a stale or missing watched floor
+ * or a pending wake only ever sends a tick down the full walk path, which is always correct.
+ */
+struct FGMOVEMENT_API FFGRestState
+{
+	/** @return Whether a mover in this state is at rest and may skip its floor and collision work. */
+	bool IsResting(const FFGMoverSyncState& SyncState) const;
+
+	/**
+	 * Feed the outcome of a full walk tick, going to rest after enough idle ticks in a row.
+	 *
+	 * @param bIdle - Whether the tick had no input, no mode change and ended near standstill.
+	 * @param Floor - The floor the tick ended on, watched while resting.
+	 * @param StartIdleTicks - Idle ticks in a row before this one, 0 if the tick woke the mover.
+	 * @param OutSyncState - The tick's output state, gets the new idle tick count and resting flag.
+	 */
+	void Update(bool bIdle, const FFloorCheckResult& Floor, uint8 StartIdleTicks, FFGMoverSyncState& OutSyncState);
+
+	/** @return Whether a resting mover may skip this tick - nothing is asking it to move and its floor is still there. */
+	bool CanStayAtRest(const FFGMoverInputCmd& Input, const FProposedMove& ProposedMove) const;
+
+	/** Ask a resting mover to leave rest, its next tick runs the full walk path and starts counting idle ticks again. */
+	void Wake() { bWakeRequested = true; }
+
+private:
+
+	FTransform									FloorTransform;
+	TWeakObjectPtr<const UPrimitiveComponent>	FloorPrimitive;
+	bool										bWakeRequested	= false;
+};
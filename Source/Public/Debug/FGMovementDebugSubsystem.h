@@ -0,0 +1,87 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Containers/StaticArray.h"
+#include "FGMovementDefines.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FGMovementDebugSubsystem.generated.h"
+
+class UFGMoverComponent;
+
+/**
+ * One frame of a mover's state, as drawn by UFGMovementDebugSubsystem.
+ */
+struct FFGDebugSample
+{
+	FVector		Location		= FVector::ZeroVector;	// Feet.
+	FVector		Velocity		= FVector::ZeroVector;
+	FVector		FloorNormal		= FVector::ZeroVector;	// Zero without a floor.
+	EFGModeId	Mode			= EFGModeId::None;
+	bool		bWalkableFloor	= false;
+};
+
+/**
+ * Movement debug drawing for the movers that opted in, off by default.
+ *
+ * Once a frame each opted in mover's state is read once - feet, velocity, mode and the floor its
+ * last tick found - into a small ring buffer, and the whole lot is drawn as trails (coloured by
+ * mode), floor normals and velocity vectors in a single batch of lines. Nothing is recorded or
+ * drawn unless FG.DrawMovementDebug is set and at least one mover opted in, and the subsystem
+ * doesn't exist at all on dedicated servers or in builds without debug drawing.
+ *
+ *		FG.DrawMovementDebug 1
+ *		FG.Debug.Draw [PawnName|all|none]
+ */
+UCLASS()
+class FGMOVEMENT_API UFGMovementDebugSubsystem final : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+
+	static constexpr int32 Capacity = 120;
+
+	//~ Begin UTickableWorldSubsystem
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	//~ End UTickableWorldSubsystem
+
+	//~ Begin UWorldSubsystem
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem
+
+	/** Start or stop drawing a mover. Stopping forgets its trail. */
+	UFUNCTION(BlueprintCallable, Category = "FG Movement|Debug")
+	void SetDrawEnabled(UFGMoverComponent* Mover, bool bEnabled);
+
+	UFUNCTION(BlueprintCallable, Category = "FG Movement|Debug")
+	bool IsDrawEnabled(const UFGMoverComponent* Mover) const;
+
+	/** Stop drawing every mover. */
+	UFUNCTION(BlueprintCallable, Category = "FG Movement|Debug")
+	void ClearDrawn() { Tracks.Reset(); }
+
+private:
+
+	struct FTrack
+	{
+		TWeakObjectPtr<UFGMoverComponent>			Mover;
+		TStaticArray<FFGDebugSample, Capacity>	Samples;
+		int32									Head	= 0;	// Next slot to write to.
+		int32									Num		= 0;	// Number of valid samples.
+
+		void Record(UFGMoverComponent& InMover);
+		const FFGDebugSample& GetSample(int32 Idx) const { return Samples[(Head - Num + Idx + Capacity) % Capacity]; }
+	};
+
+	TArray<FTrack> Tracks;
+};
@@ -23,4 +23,32 @@ namespace FG::CVars
 	extern float	SlipFactor;
 	extern float	AirSpeed;
 	extern float	GravitySpeed;
+	extern float	TickBudgetUs;
+	extern int32	TickSweepBudget;
+	extern bool		FloorCacheEnabled;
+	extern int32	FloorCacheMaxReuse;
+	extern float	FloorCacheTolerance;
+	extern float	FloorCacheReuseDistance;
+	extern bool		FlightRecorderEnabled;
+	extern bool		ProxyLODEnabled;
+	extern float	ProxyLODNearDistance;
+	extern float	ProxyLODFarDistance;
+	extern float	ProxyLODOffscreenTime;
+	extern float	ProxyLODMinimalInterval;
+	extern bool		RestEnabled;
+	extern int32	RestTicks;
+	extern float	RestVelocity;
+	extern bool		BallisticEnabled;
+	extern float	BallisticHorizon;
+	extern int32	SlideMaxPlanes;
+	extern int32	SlideMaxSweeps;
+	extern float	SurfMinNormalZ;
+	extern float	SurfWalkHysteresis;
+	extern float	WalkSnapDistance;
+	extern int32	WalkLostFloorTicks;
+	extern bool		ParallelFloorBatch;
+	extern int32	ParallelTasks;
+	extern bool		FloorHistoryEnabled;
+	extern float	FloorHistoryTolerance;
+	extern float	InputReplayTolerance;
 }
\ No newline at end of file
@@ -9,10 +9,42 @@
 
 #pragma once
 
+/**
+ * Compact id of an FG mode, cheaper to compare on hot paths than the mode name. Never
+ * replicated with the sync state - Mover already sends the mode name, see UFGMoverComponent::GetModeId.
+ */
+enum class EFGModeId : uint8
+{
+	None,
+	Walk,
+	Air,
+	Surf,
+	Num,
+};
+
+/**
+ * Movement LOD of a simulated proxy on a client, picked from the distance to the closest
+ * local viewpoint and whether the pawn was rendered recently. See the FG.LOD CVars.
+ */
+enum class EFGProxyLOD : uint8
+{
+	Full,		// Near and visible - snapshots applied every frame.
+	Reduced,	// Mid range - snapshots applied every frame, no overlaps.
+	Minimal,	// Far or offscreen - snapshots applied every FG.LOD.MinimalInterval, no overlaps.
+	Num,
+};
+
 namespace FG::Modes
 {
 	extern FGMOVEMENT_API const FLazyName Air;
 	extern FGMOVEMENT_API const FLazyName Walk;
+	extern FGMOVEMENT_API const FLazyName Surf;
+
+	/** @return The compact id of an FG mode name, None for anything that isn't an FG mode. */
+	FGMOVEMENT_API EFGModeId ToId(const FName& ModeName);
+
+	/** @return The mode name of an FG mode id, None for EFGModeId::None. */
+	FGMOVEMENT_API FName ToName(EFGModeId ModeId);
 }
 
 namespace FG::Blackboard 
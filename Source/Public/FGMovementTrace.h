@@ -0,0 +1,61 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include <atomic>
+
+/**
+ * FGMovement trace channel - enable with -trace=cpu,FGMovement to see FG scopes in Insights.
+ * The per frame counters below are exported both as trace counters and as CSV stats in the
+ * FGMovement category (-csvCategories=FGMovement), so server captures show movement cost
+ * next to the number of movers.
+ */
+UE_TRACE_CHANNEL_EXTERN(FGMovementChannel, FGMOVEMENT_API);
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(FGMOVEMENT_API, FGMovement);
+
+#define FG_SCOPE_CYCLE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, FGMovementChannel)
+
+namespace FG::Trace
+{
+	/** Counters accumulated over a frame from any thread, flushed at the end of the frame. */
+	struct FFrameCounters
+	{
+		std::atomic<int32> SimTicks				{ 0 };
+		std::atomic<int32> Sweeps				{ 0 };
+		std::atomic<int32> SlideIterations		{ 0 };
+		std::atomic<int32> ModeTransitions		{ 0 };
+		std::atomic<int32> WalkAirTransitions	{ 0 };
+		std::atomic<int32> Teleports			{ 0 };
+		std::atomic<int32> LayeredMovesQueued	{ 0 };
+		std::atomic<int32> HeapAllocations		{ 0 };	// FG pooled types that had to hit the heap.
+		std::atomic<int32> RestTicks			{ 0 };	// Sim ticks that took the resting fast path.
+		std::atomic<int32> BallisticTicks		{ 0 };	// Sim ticks that followed a ballistic arc.
+		std::atomic<int32> FloorPrefetchHits	{ 0 };	// Floor queries answered by the batched sweeps.
+		std::atomic<int32> FloorPrefetchMisses	{ 0 };	// Batched sweeps that were out of date by the time they were needed.
+		std::atomic<int32> ResimTicks			{ 0 };	// Sim ticks replaying a frame after a correction.
+		std::atomic<int32> FloorHistoryHits		{ 0 };	// Floor queries answered by FFGFloorHistory.
+		std::atomic<int32> NumMovers			{ 0 };	// Not reset per frame.
+		std::atomic<int32> ProxiesFull			{ 0 };	// Simulated proxies per LOD, not reset per frame.
+		std::atomic<int32> ProxiesReduced		{ 0 };
+		std::atomic<int32> ProxiesMinimal		{ 0 };
+	};
+
+	extern FGMOVEMENT_API FFrameCounters FrameCounters;
+
+	FORCEINLINE void Count(std::atomic<int32>& Counter, int32 Amount = 1)
+	{
+		Counter.fetch_add(Amount, std::memory_order_relaxed);
+	}
+
+	/** Publish this frame's counters to trace and CSV, then reset them. */
+	void FlushFrameCounters();
+}
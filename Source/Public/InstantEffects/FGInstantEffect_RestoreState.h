@@ -0,0 +1,46 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "InstantMovementEffect.h"
+#include "FGMovementDefines.h"
+#include "FGInstantEffect_RestoreState.generated.h"
+
+/**
+ * Puts the mover at a location, rotation and velocity in a mode, all at once and through the
+ * simulation, so it's predicted and rolled back like any other change to the sync state.
+ * Used to start input replays from exactly where their recording started.
+ */
+USTRUCT()
+struct FGMOVEMENT_API FFGInstantEffect_RestoreState : public FInstantMovementEffect
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+
+	UPROPERTY()
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	UPROPERTY()
+	FVector Velocity = FVector::ZeroVector;
+
+	EFGModeId ModeId = EFGModeId::None;
+
+	//~ Begin FInstantMovementEffect
+	virtual bool ApplyMovementEffect(FApplyMovementEffectParams& ApplyEffectParams, FMoverSyncState& OutputState) override;
+	virtual FInstantMovementEffect* Clone() const override;
+	virtual void NetSerialize(FArchive& Ar) override;
+	virtual UScriptStruct* GetScriptStruct() const override;
+	virtual FString ToSimpleString() const override;
+	virtual void AddReferencedObjects(class FReferenceCollector& Collector) override;
+	//~ End FInstantMovementEffect
+};
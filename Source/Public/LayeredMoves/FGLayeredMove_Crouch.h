@@ -10,6 +10,7 @@
 #pragma once
 
 #include "LayeredMove.h"
+#include "Core/FGPooledAllocator.h"
 #include "FGLayeredMove_Crouch.generated.h"
 
 USTRUCT()
@@ -18,6 +19,7 @@ struct FGMOVEMENT_API FFGLayeredMove_Crouch : public FLayeredMoveBase
 	GENERATED_BODY()
 
 	FFGLayeredMove_Crouch();
+	FG_DECLARE_POOLED_ALLOCATOR()
 
 	//~ Begin FLayeredMoveBase
 	virtual bool GenerateMove(const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, const UMoverComponent* MoverComp, UMoverBlackboard* SimBlackboard, FProposedMove& OutProposedMove) override;
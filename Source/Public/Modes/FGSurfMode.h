@@ -0,0 +1,33 @@
+﻿// Copyright (c) 2024 Daft Software
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "MovementMode.h"
+#include "FGSurfMode.generated.h"
+
+/**
+ * Surfing - sliding along a surface too steep to walk on but not a wall, like the surf
+ * ramps in the example content. Velocity is kept on the ramp plane analytically, so the
+ * move sweep runs along the ramp instead of into it. That also keeps the mover on the
+ * ramp's plane, so on a box ramp FFGFloorCache reprojects the floor hit instead of
+ * sweeping for it every tick, until the footprint reaches the ramp's edge.
+ */
+UCLASS()
+class FGMOVEMENT_API UFGSurfMode final : public UBaseMovementMode
+{
+public:
+	GENERATED_BODY()
+
+	//~ Begin UBaseMovementMode
+	void OnGenerateMove(const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, FProposedMove& OutProposedMove) const override;
+	void OnSimulationTick(const FSimulationTickParams& Params, FMoverTickEndData& OutputState) override;
+	//~ End UBaseMovementMode
+
+};
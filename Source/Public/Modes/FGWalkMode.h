@@ -12,7 +12,7 @@
 #include "MovementMode.h"
 #include "FGWalkMode.generated.h"
 
-struct FFGMoverInputCmd;
+struct FFGMovementContext;
 
 UCLASS()
 class FGMOVEMENT_API UFGWalkMode final : public UBaseMovementMode
@@ -27,5 +27,5 @@ public:
 	void OnSimulationTick(const FSimulationTickParams& Params, FMoverTickEndData& OutputState) override;
 	//~ End UBaseMovementMode
 
-	bool TryJump(const FFGMoverInputCmd* InputCmd, FMoverTickEndData& OutputState);
+	bool TryJump(const FFGMovementContext& Ctx, FMoverTickEndData& OutputState);
 };
@@ -10,8 +10,11 @@
 #pragma once
 
 #include "MovementModeTransition.h"
+#include "Templates/SharedPointer.h"
 #include "FGCrouchCheck.generated.h"
 
+struct FFGLayeredMove_Crouch;
+
 UCLASS()
 class FGMOVEMENT_API UFGCrouchCheck : public UBaseMovementModeTransition
 {
@@ -20,4 +23,9 @@ public:
 
 	virtual void OnTrigger(const FSimulationTickParams& Params) override;
 	virtual FTransitionEvalResult OnEvaluate(const FSimulationTickParams& Params) const override;
+
+private:
+
+	// Reused once the mover is done with it, see FG::Memory::AcquireShared.
+	TSharedPtr<FFGLayeredMove_Crouch> CachedCrouchMove;
 };